@@ -1,16 +1,33 @@
 #pragma once
 #include "GameState.h" // Includes Common.h indirectly
 #include "Common.h"    // Include directly for Move struct definition
+#include "TunedSearchParams.h"
+#include "Book.h"
 #include <vector>
 #include <limits>
 #include <cstdint>   // For uint64_t
 #include <vector>    // For std::vector
+#include <string>
+#include <atomic>    // For the stop flag
+#include <chrono>
 
 //vvv NEW vvv --- Control Macro for TT --- vvv
 // Comment out this line to disable TTs completely at compile time
 #define USE_TRANSPOSITION_TABLE
 //^^^ NEW ^^^------------------------------^^^
 
+// --- Control Macro for Evaluation Cache ---
+// Comment out this line to evaluate every leaf from scratch
+#define USE_EVAL_CACHE
+
+// --- Control Macro for Lazy Evaluation ---
+// Comment out this line to always compute the full evaluation at leaves
+#define USE_LAZY_EVAL
+
+// --- Control Macro for Search Statistics ---
+// Comment out this line to drop the per-search counters (AIMoveInfo::stats stays all zero)
+#define USE_SEARCH_STATS
+
 
 // Helper Structure for Scored Moves (Defined here)
 struct ScoredMove {
@@ -42,36 +59,198 @@ struct TTEntry {
 #endif // USE_TRANSPOSITION_TABLE
 
 
+#ifdef USE_EVAL_CACHE
+// Evaluation Cache Entry (direct-mapped, 8 bytes)
+struct EvalCacheEntry {
+    uint32_t keyCheck = 0; // Upper 32 bits of getHashKeyWithWeakened() (Zobrist low bits select the slot); 0 = empty, so stored as 1 when zero
+    int32_t score = 0;     // Evaluation::evaluateBoard() result
+};
+#endif // USE_EVAL_CACHE
+
+
+// Detailed statistics of one search (or several, see add()). Counters are collected whenever
+// USE_SEARCH_STATS is defined; the movegen/eval time split only after Engine::setTimingStats(true),
+// since it reads the CPU clock around every movegen and leaf evaluation.
+struct SearchStats {
+    static const int MAX_PLY = 64;
+    uint64_t nodesPerPly[MAX_PLY] = {}; // Nodes by distance from the root (0 = root; deeper plies count in the last slot)
+    uint64_t quiescenceNodes = 0;       // The search has no quiescence stage, so always 0 (kept for a stable format)
+    uint64_t cutoffs = 0;               // Interior nodes that failed high (alpha >= beta after a move)
+    uint64_t firstMoveCutoffs = 0;      // ...on the first move searched
+    uint64_t ttProbes = 0;
+    uint64_t ttHits = 0;                // Slot held this position (any depth)
+    uint64_t ttCutoffs = 0;             // Node answered from the TT without searching
+    uint64_t ttCollisions = 0;          // Slot held a different position
+    uint64_t evalCacheHits = 0;
+    uint64_t evalCacheMisses = 0;
+    uint64_t movegenTicks = 0;          // CPU clock ticks in getAllLegalMoves (timing only)
+    uint64_t evalTicks = 0;             // CPU clock ticks in leaf evaluation (timing only)
+    uint64_t totalTicks = 0;            // CPU clock ticks for the whole search (timing only)
+    double timeMs = 0.0;                // Wall time
+
+    void add(const SearchStats& other); // Sums another search in (e.g. the iterations of one move)
+    uint64_t totalNodes() const;
+    double effectiveBranchingFactor() const; // Geometric mean growth per ply over nodesPerPly
+    // One JSON object: nodes, nodes_per_ply, quiescence_nodes, ebf, first_move_cutoff_pct, tt {...},
+    // eval_cache_hit_pct and time_ms {total, movegen, eval, search} (the split is null without timing)
+    std::string toJson() const;
+};
+
+
 // Struct to return AI results
 struct AIMoveInfo {
     Move bestMove = {-1,-1,-1,-1};
     uint64_t nodesSearched = 0;
-    double ttUtilizationPercent = 0.0; // Will be 0 if TT is disabled
     int finalScore = 0; // The raw evaluation score of the chosen move
+    uint64_t evalCacheHits = 0;   // Leaf evaluations served from the eval cache
+    uint64_t evalCacheMisses = 0; // Leaf evaluations computed (0/0 if cache is disabled)
+    uint64_t lazyEvalExits = 0;   // Leaf evaluations that stopped after material + PST (0 if lazy eval is disabled)
+    bool aborted = false;         // Stopped by requestStop() or a search limit: bestMove/finalScore are incomplete
+    SearchStats stats;            // See USE_SEARCH_STATS
 };
 
 
-class AI {
+// --- Search Engine Instance ---
+// Owns everything a search touches: TT, eval cache, counters, search parameters and limits,
+// and an opening book. Engines are independent, so several can search at once in one
+// process (one thread each), each with its own TT size.
+class Engine {
 public:
+    // ttSizeMB = 0: default TT size (2^DEFAULT_TT_SIZE_POWER_OF_2 entries). Tables are allocated on first use.
+    explicit Engine(size_t ttSizeMB = 0);
+    Engine(const Engine&) = delete;
+    Engine& operator=(const Engine&) = delete;
+
     // Finds the best move using Alpha-Beta Pruning search
-    static AIMoveInfo getBestMove(const GameState& currentGameState, int searchDepth, bool debugMode = false, bool quietMode = false);
+    AIMoveInfo getBestMove(const GameState& currentGameState, int searchDepth, bool debugMode = false, bool quietMode = false);
+
+    // --- Search Parameters (start out as DEFAULT_SEARCH_PARAMS) ---
+    void setSearchParams(const SearchParams& params) { searchParams = params; }
+    const SearchParams& getSearchParams() const { return searchParams; }
+
+    // --- Search Control ---
+    // Limits apply to each getBestMove() call from its start (0 = none). requestStop() may be
+    // called from another thread; the flag stays set until clearStop().
+    void setSearchLimits(uint64_t nodeLimit, int64_t timeLimitMs);
+    void requestStop() { stopRequested.store(true, std::memory_order_relaxed); }
+    void clearStop() { stopRequested.store(false, std::memory_order_relaxed); }
+    bool isStopRequested() const { return stopRequested.load(std::memory_order_relaxed); }
+
+    // Collect the movegen/eval time split in AIMoveInfo::stats (costs a few percent of speed)
+    void setTimingStats(bool enabled) { timingStats = enabled; }
+
+    // Best line after a search: firstMove, then the TT's best moves (stops at a missing/illegal entry)
+    std::vector<Move> getPrincipalVariation(const GameState& rootState, const Move& firstMove, int maxLength) const;
+
+    // Opening book used by this engine's owner (the search itself doesn't consult it)
+    Book::OpeningBook& getBook() { return book; }
+
+#ifdef USE_TRANSPOSITION_TABLE
+    // --- TT Snapshots (persistent analysis cache) ---
+    // When enabled, the TT is no longer cleared before each search, so work accumulates over a session.
+    void setPersistentTT(bool persistent);
+    // Resizes the TT to the largest power-of-2 entry count that fits in sizeMB (clears it)
+    bool setTTSizeMB(size_t sizeMB);
+    void clearTT();
+    // Percentage of used TT slots. Scans the whole table (tens of ms for large hashes),
+    // so call it on demand for display, never per search or iteration.
+    double getTTUtilization() const;
+    // Writes the whole TT to a versioned binary file. Returns false on I/O error.
+    bool saveTranspositionTable(const std::string& filename) const;
+    // Maps a snapshot file (mmap where available) and copies it into the TT.
+    // Rejects files whose version, Zobrist keys or entry layout don't match this build.
+    bool loadTranspositionTable(const std::string& filename);
+
+    // --- Direct TT Access (microbenchmarks, tools) ---
+    // Same slot and replacement rule as the search: probe returns nullptr unless the slot holds hashKey.
+    const TTEntry* probeTT(uint64_t hashKey) const {
+        if (!ttInitialized) return nullptr;
+        const TTEntry& entry = transpositionTable[hashKey & (ttSize - 1)];
+        return (entry.key == hashKey) ? &entry : nullptr;
+    }
+    void storeTT(uint64_t hashKey, int depth, int score, TTBound bound, const Move& bestMove) {
+        allocateTT(true);
+        TTEntry& entry = transpositionTable[hashKey & (ttSize - 1)];
+        if (entry.depth <= depth) entry = {hashKey, depth, score, bound, bestMove};
+    }
+#endif // USE_TRANSPOSITION_TABLE
 
 private:
 #ifdef USE_TRANSPOSITION_TABLE // Only declare TT members if using TTs
     // TT stuff
-    static const size_t TT_SIZE_POWER_OF_2 = 22; // 2^22 = ~4 Million entries
-    static const size_t TT_SIZE = 1 << TT_SIZE_POWER_OF_2;
-    static std::vector<TTEntry> transpositionTable;
-    static bool ttInitialized;
-    static void initializeTT();
-    static double getTTUtilization();
+    static const size_t DEFAULT_TT_SIZE_POWER_OF_2 = 22; // 2^22 = ~4 Million entries
+    size_t ttSize = size_t(1) << DEFAULT_TT_SIZE_POWER_OF_2; // Power of 2 (setTTSizeMB)
+    std::vector<TTEntry> transpositionTable;
+    bool ttInitialized = false;
+    bool ttPersistent = false; // Keep entries between searches (set for snapshot load/save)
+    void allocateTT(bool quietMode = false);
+    void initializeTT(bool quietMode);
+    void prefetchTTEntry(uint64_t hashKey) const; // Pulls the child's TT bucket into cache before recursion
 #endif // USE_TRANSPOSITION_TABLE
 
+#ifdef USE_EVAL_CACHE
+    static const size_t EVAL_CACHE_SIZE_POWER_OF_2 = 20; // 2^20 = ~1 Million entries (8 MB)
+    static const size_t EVAL_CACHE_SIZE = 1 << EVAL_CACHE_SIZE_POWER_OF_2;
+    std::vector<EvalCacheEntry> evalCache; // Entries never need clearing: a position's evaluation doesn't change between searches
+    uint64_t evalCacheHits = 0;
+    uint64_t evalCacheMisses = 0;
+    void prefetchEvalCacheEntry(uint64_t hashKey) const;
+#endif // USE_EVAL_CACHE
+
     // Node counter (always needed)
-    static uint64_t nodesSearched;
+    uint64_t nodesSearched = 0;
+
+    SearchParams searchParams = DEFAULT_SEARCH_PARAMS;
+
+    // Search control (see setSearchLimits)
+    std::atomic<bool> stopRequested{false};
+    uint64_t nodeLimit = 0;
+    int64_t timeLimitMs = 0;
+    std::chrono::steady_clock::time_point searchStart;
+    bool searchAborted = false; // Set once a limit/stop is hit; unwinds the search without storing results
+    bool checkAbort();
+
+#ifdef USE_LAZY_EVAL
+    uint64_t lazyEvalExits = 0;
+#endif // USE_LAZY_EVAL
+
+    Book::OpeningBook book;
 
-    // AlphaBeta signature (unchanged)
-    static int alphaBeta(GameState gameState, int depth, int maxDepth, int alpha, int beta, bool isMaximizingPlayer, bool debugMode);
+    SearchStats stats;         // Current search (copied into AIMoveInfo)
+    bool timingStats = false;
+    uint64_t statsStartTicks = 0;
+    void finishStats(AIMoveInfo& result);
+
+    // Leaf evaluation (goes through the eval cache when enabled; alpha/beta allow a lazy early exit)
+    int evaluateLeaf(const GameState& gameState, int alpha, int beta);
+
+    // Search templated on the side to move (Player 2 maximizes, Player 1 minimizes), so the
+    // maximizing/minimizing comparisons and bound bookkeeping are resolved at compile time.
+    template <Player Us>
+    AIMoveInfo searchRoot(const GameState& currentGameState, int searchDepth, bool debugMode, bool quietMode);
+    template <Player Us>
+    int alphaBeta(GameState gameState, int depth, int maxDepth, int alpha, int beta, bool debugMode);
 };
 
 
+// --- Process-Wide Default Engine ---
+// Static front end for code that only ever runs one search at a time (the GUI):
+// every call forwards to one Engine instance created on first use.
+class AI {
+public:
+    static Engine& defaultEngine();
+
+    static AIMoveInfo getBestMove(const GameState& currentGameState, int searchDepth, bool debugMode = false, bool quietMode = false) {
+        return defaultEngine().getBestMove(currentGameState, searchDepth, debugMode, quietMode);
+    }
+    static void setSearchParams(const SearchParams& params) { defaultEngine().setSearchParams(params); }
+    static void setTimingStats(bool enabled) { defaultEngine().setTimingStats(enabled); }
+    static const SearchParams& getSearchParams() { return defaultEngine().getSearchParams(); }
+
+#ifdef USE_TRANSPOSITION_TABLE
+    static void setPersistentTT(bool persistent) { defaultEngine().setPersistentTT(persistent); }
+    static double getTTUtilization() { return defaultEngine().getTTUtilization(); }
+    static bool saveTranspositionTable(const std::string& filename) { return defaultEngine().saveTranspositionTable(filename); }
+    static bool loadTranspositionTable(const std::string& filename) { return defaultEngine().loadTranspositionTable(filename); }
+#endif // USE_TRANSPOSITION_TABLE
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Fixed-position search benchmark (jungle_chess --bench, jungle_engine bench).
+//
+// Searches a built-in suite of positions (opening, middlegame, den races, sparse endgames)
+// to a fixed depth, each with a fresh Engine, and prints total nodes, time, NPS and a
+// signature over the per-position node counts and best moves. For a given depth and hash
+// size the signature doesn't depend on the thread count or the host, so a change means
+// the search now visits a different tree.
+namespace Bench {
+
+    constexpr int DEFAULT_DEPTH = 5;
+    constexpr size_t DEFAULT_HASH_MB = 16;
+
+    struct BenchResult {
+        int positions = 0;
+        uint64_t nodes = 0;
+        int64_t timeMs = 0;
+        uint64_t signature = 0;
+    };
+
+    // Number of positions in the built-in suite, and position i in GameState notation
+    int suiteSize();
+    const char* suitePosition(int index);
+
+    // Runs the suite with `threads` worker threads (positions are shared out; the node counts
+    // and signature don't depend on the thread count). Per-position lines are skipped in quietMode.
+    BenchResult run(int depth = DEFAULT_DEPTH, int threads = 1, size_t hashMB = DEFAULT_HASH_MB, bool quietMode = false);
+
+} // namespace Bench
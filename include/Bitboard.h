@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Common.h"
+#include <array>
+#include <cstdint>
+
+// 63-square bitboards: bit (r * BOARD_COLS + c). Used for set-wise mobility/threat terms.
+namespace Bitboard {
+
+    constexpr int NUM_SQUARES = BOARD_ROWS * BOARD_COLS;
+
+    constexpr uint64_t squareBit(int r, int c) { return 1ULL << (r * BOARD_COLS + c); }
+
+    // Hardware POPCNT when the build targets it (-march=native), otherwise an inline SWAR
+    // count: __builtin_popcountll without -mpopcnt is an out-of-line libgcc call.
+    inline int popcount(uint64_t bb) {
+#if defined(__POPCNT__) && (defined(__GNUC__) || defined(__clang__))
+        return __builtin_popcountll(bb);
+#else
+        bb = bb - ((bb >> 1) & 0x5555555555555555ULL);
+        bb = (bb & 0x3333333333333333ULL) + ((bb >> 2) & 0x3333333333333333ULL);
+        bb = (bb + (bb >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+        return static_cast<int>((bb * 0x0101010101010101ULL) >> 56);
+#endif
+    }
+
+    inline int lowestSquare(uint64_t bb) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(bb);
+#else
+        int sq = 0; while (!(bb & 1ULL)) { bb >>= 1; ++sq; } return sq;
+#endif
+    }
+
+    // --- Board Masks ---
+    constexpr uint64_t buildMask(bool (*predicate)(int, int)) {
+        uint64_t mask = 0;
+        for (int r = 0; r < BOARD_ROWS; ++r)
+            for (int c = 0; c < BOARD_COLS; ++c)
+                if (predicate(r, c)) mask |= squareBit(r, c);
+        return mask;
+    }
+
+    constexpr bool isRiverSquare(int r, int c) { return (r >= 3 && r <= 5) && (c == 1 || c == 2 || c == 4 || c == 5); }
+
+    constexpr uint64_t ALL_SQUARES = buildMask([](int, int) { return true; });
+    constexpr uint64_t RIVER = buildMask(isRiverSquare);
+    constexpr uint64_t LAND = ALL_SQUARES & ~RIVER;
+    constexpr uint64_t NOT_COL_FIRST = buildMask([](int, int c) { return c != 0; });
+    constexpr uint64_t NOT_COL_LAST = buildMask([](int, int c) { return c != BOARD_COLS - 1; });
+
+    constexpr uint64_t denMask(Player player) { return player == Player::PLAYER1 ? squareBit(0, 3) : squareBit(8, 3); }
+    constexpr uint64_t trapMask(Player player) {
+        return player == Player::PLAYER1 ? (squareBit(0, 2) | squareBit(0, 4) | squareBit(1, 3))
+                                         : (squareBit(8, 2) | squareBit(8, 4) | squareBit(7, 3));
+    }
+
+    // --- Orthogonal Steps (set-wise) ---
+    inline uint64_t stepTargets(uint64_t bb) {
+        return ((bb << BOARD_COLS) & ALL_SQUARES)         // r + 1
+             | (bb >> BOARD_COLS)                          // r - 1
+             | ((bb & NOT_COL_LAST) << 1)                  // c + 1
+             | ((bb & NOT_COL_FIRST) >> 1);                // c - 1
+    }
+
+    // --- River Lanes ---
+    // The ten straight river segments a Lion/Tiger can jump across: 4 vertical (cols 1, 2, 4, 5)
+    // and 6 horizontal (rows 3-5, left and right lake). Lane index = position in this array.
+    constexpr int NUM_RIVER_LANES = 10;
+    constexpr uint64_t columnSegment(int c) { return squareBit(3, c) | squareBit(4, c) | squareBit(5, c); }
+    constexpr uint64_t rowSegment(int r, int c) { return squareBit(r, c) | squareBit(r, c + 1); }
+    constexpr uint64_t RIVER_LANES[NUM_RIVER_LANES] = {
+        columnSegment(1), columnSegment(2), columnSegment(4), columnSegment(5),
+        rowSegment(3, 1), rowSegment(4, 1), rowSegment(5, 1),
+        rowSegment(3, 4), rowSegment(4, 4), rowSegment(5, 4)
+    };
+
+    // --- Lion/Tiger Jump Lanes ---
+    // For each square, up to two jumps across the river: destination square, river lane index
+    // and the river squares that must be empty. Destination -1 = unused slot.
+    struct JumpLane { int8_t to; int8_t lane; uint64_t riverSquares; };
+    using JumpTable = std::array<std::array<JumpLane, 2>, NUM_SQUARES>;
+
+    constexpr JumpTable buildJumpTable() {
+        JumpTable table{};
+        for (auto& lanes : table) for (auto& lane : lanes) { lane.to = -1; lane.lane = -1; lane.riverSquares = 0; }
+        const int dirs[4][2] = {{0, 1}, {0, -1}, {1, 0}, {-1, 0}};
+        for (int r = 0; r < BOARD_ROWS; ++r) {
+            for (int c = 0; c < BOARD_COLS; ++c) {
+                if (isRiverSquare(r, c)) continue;
+                int slot = 0;
+                for (const auto& d : dirs) {
+                    int length = (d[0] == 0) ? 3 : 4; // Horizontal jumps cross 2 river squares, vertical 3
+                    int tr = r + d[0] * length, tc = c + d[1] * length;
+                    if (tr < 0 || tr >= BOARD_ROWS || tc < 0 || tc >= BOARD_COLS || isRiverSquare(tr, tc)) continue;
+                    uint64_t river = 0; bool allRiver = true;
+                    for (int k = 1; k < length; ++k) {
+                        if (!isRiverSquare(r + d[0] * k, c + d[1] * k)) allRiver = false;
+                        river |= squareBit(r + d[0] * k, c + d[1] * k);
+                    }
+                    if (!allRiver) continue;
+                    int8_t laneIndex = -1;
+                    for (int l = 0; l < NUM_RIVER_LANES; ++l) if (RIVER_LANES[l] == river) laneIndex = static_cast<int8_t>(l);
+                    table[r * BOARD_COLS + c][slot].to = static_cast<int8_t>(tr * BOARD_COLS + tc);
+                    table[r * BOARD_COLS + c][slot].lane = laneIndex;
+                    table[r * BOARD_COLS + c][slot].riverSquares = river;
+                    ++slot;
+                }
+            }
+        }
+        return table;
+    }
+
+    inline constexpr JumpTable jumpLanes = buildJumpTable();
+
+    // Jump destinations for all Lions/Tigers in bb, given the full occupancy (rats block lanes)
+    inline uint64_t jumpTargets(uint64_t bb, uint64_t occupied) {
+        uint64_t targets = 0;
+        while (bb) {
+            int sq = lowestSquare(bb); bb &= bb - 1;
+            for (const JumpLane& lane : jumpLanes[sq]) {
+                if (lane.to >= 0 && !(lane.riverSquares & occupied)) targets |= (1ULL << lane.to);
+            }
+        }
+        return targets;
+    }
+
+} // namespace Bitboard
@@ -18,6 +18,40 @@ namespace Book {
         ALREADY_EXISTS      // Identical or shorter variation already present
     };
 
+    // One loaded book: its variations and the RNG that picks among matching moves.
+    // Independent instances can be used from different threads.
+    class OpeningBook {
+    public:
+        OpeningBook();
+
+        // Loads the opening book from the specified file.
+        // Parses algebraic notation (e.g., "a1b1 c7c6").
+        // Returns true if loading was successful and the book is not empty.
+        bool load(const std::string& filename = "opening_book.txt");
+
+        // Finds a book move based on the sequence of moves played so far.
+        // Returns a valid Move if found, otherwise returns {-1,-1,-1,-1}.
+        Move findBookMove(const std::vector<Move>& moveSequence);
+
+        // Returns true if the book was loaded successfully.
+        bool isLoaded() const;
+
+        // Saves the variation: appends if new, updates if it extends an existing line.
+        // Returns enum indicating the result.
+        SaveResult saveVariation(const std::vector<Move>& moveSequence, const std::string& filename = "opening_book.txt");
+
+        // Read access to the loaded variations (e.g. for highlighting book moves)
+        const std::vector<std::vector<Move>>& getVariations() const;
+
+    private:
+        std::vector<std::vector<Move>> bookVariations;
+        bool loaded = false;
+        std::mt19937 rng; // Picks among several matching book moves
+    };
+
+    // Process-wide book used by the free functions below (the GUI's book)
+    OpeningBook& defaultBook();
+
     // Loads the opening book from the specified file.
     // Parses algebraic notation (e.g., "a1b1 c7c6").
     // Returns true if loading was successful and the book is not empty.
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Common.h"
+#include <array>
+
+namespace Evaluation {
+
+    // --- Piece-Square Tables (PSTs) ---
+    // Defined from Player 1's perspective (bottom is row 0). Will be flipped for Player 2.
+    using PieceSquareTable = std::array<std::array<int, BOARD_COLS>, BOARD_ROWS>;
+
+    // One table per index below (Cat and Dog share a table)
+    enum PstIndex { PST_RAT, PST_CAT_DOG, PST_WOLF, PST_LEOPARD, PST_TIGER, PST_LION, PST_ELEPHANT, NUM_PSTS };
+
+    constexpr int pstIndexFor(PieceType type) {
+        switch (type) {
+            case PieceType::RAT:      return PST_RAT;
+            case PieceType::CAT:      case PieceType::DOG: return PST_CAT_DOG;
+            case PieceType::WOLF:     return PST_WOLF;
+            case PieceType::LEOPARD:  return PST_LEOPARD;
+            case PieceType::TIGER:    return PST_TIGER;
+            case PieceType::LION:     return PST_LION;
+            case PieceType::ELEPHANT: return PST_ELEPHANT;
+            default:                  return -1;
+        }
+    }
+
+    // --- Tunable Evaluation Parameters ---
+    // Everything the Texel tuner (src/Tune.cpp) may change at runtime. The defaults live in the
+    // generated TunedEvalParams.h; geometry (distances, thresholds) stays in Evaluation.h.
+    struct EvalParams {
+        std::array<int, static_cast<int>(PieceType::ELEPHANT) + 1> pieceValue; // Indexed by PieceType (EMPTY = 0)
+        std::array<PieceSquareTable, NUM_PSTS> pst;
+
+        int mobilityWeight;               // Per legal move
+        int captureThreatPct;             // Pct of value of each opponent piece we could capture next move
+        int elephantTrapPenalty;          // Elephant on the edge with the enemy rat adjacent (scaled down with distance)
+        int ratInterceptMaxBonus;         // Rat in a river lane an enemy Lion/Tiger could jump across
+        int denSafetyBaseScore;           // Per step inside DEN_SAFETY_MAX_DIST
+        double denSafetyCountMultiplier;  // Extra den threat per additional attacker
+        double trappedCornerMalusPct;     // Fraction of piece value, by distance from the corner
+        double trappedDist1MalusPct;
+        double trappedDist2MalusPct;
+        int trapControlSuicidePenaltyPct; // Pct of piece value, intruder with 2+ defenders adjacent
+        int trapControlLosingPenaltyPct;  // Pct of piece value, intruder with one defender and no (or weaker) support
+        int trapControlWinningBonus;      // Bonus if supporter >= defender
+        int trapControlSafeBonus;         // Bonus if no defenders adjacent
+    };
+
+} // namespace Evaluation
@@ -2,6 +2,10 @@
 
 #include "GameState.h" // Includes Common.h indirectly
 #include "Common.h"
+#include "NNUE.h"
+#include "Bitboard.h"
+#include "EvalParams.h"
+#include "TunedEvalParams.h"
 #include <limits>
 #include <array>
 #include <map>
@@ -12,258 +16,374 @@
 
 namespace Evaluation {
 
+    // Compile-time side flip for the side-templated helpers
+    constexpr Player opponentOf(Player player) { return player == Player::PLAYER1 ? Player::PLAYER2 : Player::PLAYER1; }
+
+    // --- Active Evaluation Parameters ---
+    // Piece values, PSTs and term weights (see EvalParams.h). Start out as DEFAULT_EVAL_PARAMS
+    // (TunedEvalParams.h); setParams() swaps them at runtime and rebuilds the derived tables below.
+    // GameStates built before a setParams() call keep stale incremental terms until setBoard().
+    extern EvalParams params;
+    bool setParams(const EvalParams& newParams); // False (and unchanged) if the values don't fit the packed tables
+
     // --- Define Material Values ---
     inline int getPieceValue(PieceType type) {
-        switch (type) {
-            case PieceType::RAT:      return 6500; case PieceType::CAT:      return 3000;
-            case PieceType::DOG:      return 4000; case PieceType::WOLF:     return 5000;
-            case PieceType::LEOPARD:  return 6000; case PieceType::TIGER:    return 7500;
-            case PieceType::LION:     return 8500; case PieceType::ELEPHANT: return 9000;
-            case PieceType::EMPTY:    return 0;    default:                  return 0;
-        }
+        return params.pieceValue[static_cast<int>(type)];
     }
 
     // --- Define Score for Winning ---
+    // A won position scores WIN_SCORE + the search depth remaining there, so sooner wins score
+    // higher. A win taken from the TT can lie beyond the current horizon and score slightly below
+    // WIN_SCORE (still a win, just further away), so test scores with isWinScore().
     const int WIN_SCORE = 1000000;
-
-    // --- Define Piece-Square Tables (PSTs) ---
-    // Defined from Player 1's perspective (bottom is row 0). Will be flipped for Player 2.
-    using PieceSquareTable = std::array<std::array<int, BOARD_COLS>, BOARD_ROWS>;
-
-    // Rat: Encourage river, advancing (Unchanged)
-    const PieceSquareTable pst_rat = {{
-        {{-5,-5, 0, 0, 0,-5,-5}}, {{ 0, 0, 5, 5, 5, 0, 0}}, {{ 5, 5,10,10,10, 5, 5}},
-        {{10,50,50,15,50,50,10}}, {{15,60,60,20,60,60,15}}, {{10,50,50,15,50,50,10}},
-        {{ 5,10,15,20,15,10, 5}}, {{ 0, 5,10,15,10, 5, 0}}, {{ 0, 0, 5, 10, 5, 0, 0}}
-    }};
-    // Cat/Dog: Encourage staying near own traps/den (Unchanged)
-    const PieceSquareTable pst_cat_dog = {{
-        {{15,10,20,25,20,10,15}}, {{10,15,15,20,15,15,10}}, {{ 5, 5, 5, 5, 5, 5, 5}},
-        {{ 0, 0, 0, 0, 0, 0, 0}}, {{-5,-5,-5,-5,-5,-5,-5}}, {{-5,-5,-5,-5,-5,-5,-5}},
-        {{-10,-10,-5,-5,-5,-10,-10}}, {{-10,-10,-10,-10,-10,-10,-10}}, {{-15,-15,-10,-10,-10,-15,-15}}
-    }};
-    // Wolf: Defensive posture (Unchanged)
-     const PieceSquareTable pst_wolf = {{
-        {{ 5, 5, 5, 5, 5, 5, 5}}, {{10,10,10,10,10,10,10}}, {{15,15,15,15,15,15,15}},
-        {{ 5, 5, 5, 5, 5, 5, 5}}, {{ 0, 0, 0, 0, 0, 0, 0}}, {{-5,-5,-5,-5,-5,-5,-5}},
-        {{-10,-10,-10,-10,-10,-10,-10}}, {{-15,-15,-15,-15,-15,-15,-15}}, {{-20,-20,-15,-15,-15,-20,-20}}
-    }};
-    // Leopard: Encourage advancing, central control (Unchanged)
-    const PieceSquareTable pst_leopard = {{
-        {{ 0, 0, 0, 0, 0, 0, 0}}, {{ 0, 5, 5, 5, 5, 5, 0}}, {{ 0, 5,10,10,10, 5, 0}},
-        {{ 5,10,15,15,15,10, 5}}, {{ 5,10,15,15,15,10, 5}}, {{10,15,20,20,20,15,10}},
-        {{10,15,20,25,20,15,10}}, {{ 5,10,15,20,15,10, 5}}, {{ 0, 5,10,15,10, 5, 0}}
-    }};
-
-    //vvv MODIFIED vvv --- Separate LION PST with strong den attack values --- vvv
-    // Row 8 = Opponent's Row 0 (Back Rank)
-    // Row 7 = Opponent's Row 1 (Trap Row)
-    // Row 6 = Opponent's Row 2
-    const PieceSquareTable pst_lion = {{
-        {{-10,-10,-10, -1,-10,-10,-10}}, // Row 0 (Own Back Rank) - Bad
-        {{ -5, -5, -5, -5, -5, -5, -5}}, // Row 1
-        {{  0,  0,  5,  5,  5,  0,  0}}, // Row 2
-        {{  5, -1, -1, 20, -1, -1,  5}}, // Row 3 (River Edge)
-        {{ 10, -1, -1, 25, -1, -1, 10}}, // Row 4 (River Middle)
-        {{ 15, -1, -1, 90, -1, -1, 15}}, // Row 5 (River Edge - Attack Side)
-        {{ 20, 30,100,220,100, 30, 20}}, // Row 6 (Opponent Territory)
-        {{ 50,100,270,550,270,100, 50}}, // Row 7 (Opponent Trap Row - High Value) - Central trap (1,3) is table[7][3]
-        {{  0,200,500,999,500,200,  0}}  // Row 8 (Opponent Back Rank - Very High Value) - Den (0,3) is table[8][3]
-        // Note: The +3000 for the central trap is handled by the TrapControl logic now, not PST.
-    }};
-    //^^^ MODIFIED ^^^--------------------------------------------------------^^^
-
-    //vvv MODIFIED vvv --- Separate TIGER PST, strong but less den-focused than Lion --- vvv
-    const PieceSquareTable pst_tiger = {{
-        {{-10,-10,-10, -1,-10,-10,-10}}, // Row 0 (Own Back Rank) - Bad
-        {{ -5, -5, -5, -5, -5, -5, -5}}, // Row 1
-        {{  0,  0,  5,  5,  5,  0,  0}}, // Row 2
-        {{  5, -1, -1, 20, -1, -1,  5}}, // Row 3 (River Edge)
-        {{ 10, -1, -1, 25, -1, -1, 10}}, // Row 4 (River Middle)
-        {{ 20, -1, -1,100, -1, -1, 20}}, // Row 5 (River Edge - Attack Side - Stronger than Lion here? [Nope - the tiger is inferior!])
-        {{ 25, 40, 95,200, 95, 40, 25}}, // Row 6 (Opponent Territory)
-        {{ 40, 80,230,450,230, 80, 40}}, // Row 7 (Opponent Trap Row - Still high value)
-        {{  0,100,400,999,400,100,  0}}  // Row 8 (Opponent Back Rank - High but less than Lion)
-    }};
-    //^^^ MODIFIED ^^^-----------------------------------------------------------^^^
-
-    //vvv MODIFIED vvv --- Revised Elephant PST (Stronger Center) --- vvv
-    const PieceSquareTable pst_elephant = {{
-        {{-30,-30,-25, -1,-25,-30,-30}}, // Row 0 (Own Back Rank) - Very Bad
-        {{-15,-15,-10, -5,-10,-15,-15}}, // Row 1 - Still bad
-        {{ -5,  0, 10, 20, 10,  0, -5}}, // Row 2 - Encouraging forward/center
-        {{  5, -1, -1, 60, -1, -1,  5}}, // Row 3 (River Edge) - Strong central presence
-        {{ 10, -1, -1, 70, -1, -1, 10}}, // Row 4 (River Middle) - Peak central control value (significant bonus)
-        {{ 10, -1, -1, 80, -1, -1, 10}}, // Row 5 (River Edge - Attack Side) - Still very strong center
-        {{ 10, 15, 50,150, 50, 15, 10}}, // Row 6 (Opponent Territory) - Positive, but less than center
-        {{  0, 25,200,400,200, 25,  0}}, // Row 7 (Opponent Trap Row) - Modest value, avoid traps
-        {{  0, 50,350,999,350, 50,  0}}  // Row 8 (Opponent Back Rank) - Low value, generally avoid
-    }};
-    //^^^ MODIFIED ^^^------------------------------------------------^^^
-
+    const int MAX_WIN_DISTANCE = 1000; // Plies; far beyond any search depth
+    inline bool isWinScore(int score) { return score >= WIN_SCORE - MAX_WIN_DISTANCE || score <= -(WIN_SCORE - MAX_WIN_DISTANCE); }
 
     // --- Function to get PST value ---
-    //vvv MODIFIED vvv --- Use separate L/T tables --- vvv
-    inline int getPstValue(PieceType type, int r, int c, Player player) {
+    constexpr int getPstValue(const EvalParams& p, PieceType type, int r, int c, Player player) {
         int table_r = (player == Player::PLAYER1) ? r : (BOARD_ROWS - 1 - r);
-        if (table_r < 0 || table_r >= BOARD_ROWS || c < 0 || c >= BOARD_COLS) return 0;
-        switch (type) {
-            case PieceType::RAT:      return pst_rat[table_r][c];
-            case PieceType::CAT:      case PieceType::DOG: return pst_cat_dog[table_r][c];
-            case PieceType::WOLF:     return pst_wolf[table_r][c];
-            case PieceType::LEOPARD:  return pst_leopard[table_r][c];
-            case PieceType::TIGER:    return pst_tiger[table_r][c]; // Use Tiger PST
-            case PieceType::LION:     return pst_lion[table_r][c];  // Use Lion PST
-            case PieceType::ELEPHANT: return pst_elephant[table_r][c];
-            default:                  return 0;
-        }
+        int index = pstIndexFor(type);
+        if (index < 0 || table_r < 0 || table_r >= BOARD_ROWS || c < 0 || c >= BOARD_COLS) return 0;
+        return p.pst[index][table_r][c];
     }
-    //^^^ MODIFIED ^^^---------------------------------^^^
 
 
     // --- Evaluation Weights ---
-    const int MATERIAL_WEIGHT_MULTIPLIER = 2;
-    const int MOBILITY_WEIGHT = 5; // Still defined, just not used in evaluateBoard below
+    // Tunable weights are in EvalParams; these are fixed geometry and scaling.
+    constexpr int MATERIAL_WEIGHT_MULTIPLIER = 2;
     const int LION_PROXIMITY_WEIGHT = 40; // Specific bonus for AI Lion near opponent den (redundant now? Keep for now)
-    const int ELEPHANT_TRAP_PENALTY = 3000;
     const int ELEPHANT_EDGE_THRESHOLD = 1;
     const int RAT_PROXIMITY_THRESHOLD = 3;
-    const double TRAPPED_CORNER_MALUS_PCT = 0.75;
-    const double TRAPPED_DIST1_MALUS_PCT = 0.60;
-    const double TRAPPED_DIST2_MALUS_PCT = 0.50;
-    const int RAT_INTERCEPT_MAX_BONUS = 1000;
     const int DEN_SAFETY_MAX_DIST = 4;
-    const int DEN_SAFETY_BASE_SCORE = 100;
-    const double DEN_SAFETY_COUNT_MULTIPLIER = 1.5;
-    const int TRAP_CONTROL_SUICIDE_PENALTY_PCT = 95; // Pct of piece value
-    const int TRAP_CONTROL_WINNING_BONUS = 2500;     // Bonus if supporter >= defender
-    const int TRAP_CONTROL_SAFE_BONUS = 1500;        // Bonus if no defenders adjacent
 
 
-    // --- Static Board Evaluation Function ---
-    inline int evaluateBoard(const GameState& gameState) {
-        int materialScore = 0; int positionalScorePST = 0;
-        int lionProximityScore = 0; int elephantTrapPenalty = 0;
-        int trappedPieceMalus = 0; int ratInterceptBonus = 0;
-        int ai_den_threat_score = 0; int opponent_den_threat_score = 0;
-        int ai_pieces_near_opponent_den = 0; int opponent_pieces_near_ai_den = 0;
-        int trapControlScore = 0;
+    // --- Precombined Material + PST Table ---
+    // value[pieceType][player][square] = weighted material + (flipped) PST for that piece on that square.
+    // GameState keeps per-side running sums of these, updated in applyMove().
+    using MaterialPstTable = std::array<std::array<std::array<int, BOARD_ROWS * BOARD_COLS>, 3>, static_cast<int>(PieceType::ELEPHANT) + 1>;
+
+    constexpr MaterialPstTable buildMaterialPstTable(const EvalParams& p) {
+        MaterialPstTable table{};
+        for (int t = 1; t <= static_cast<int>(PieceType::ELEPHANT); ++t) {
+            PieceType type = static_cast<PieceType>(t);
+            for (int pl = 1; pl <= 2; ++pl) {
+                Player player = static_cast<Player>(pl);
+                for (int r = 0; r < BOARD_ROWS; ++r) {
+                    for (int c = 0; c < BOARD_COLS; ++c) {
+                        table[t][pl][r * BOARD_COLS + c] = p.pieceValue[t] * MATERIAL_WEIGHT_MULTIPLIER + getPstValue(p, type, r, c, player);
+                    }
+                }
+            }
+        }
+        return table;
+    }
+
+    extern MaterialPstTable materialPstValue; // buildMaterialPstTable(params)
 
-        int aiElephantRow = -1, aiElephantCol = -1;
-        int humanRatRow = -1, humanRatCol = -1;
-
-        // --- Calculate Component Scores ---
-        for (int r = 0; r < BOARD_ROWS; ++r) {
-            for (int c = 0; c < BOARD_COLS; ++c) {
-                Piece piece = gameState.getPiece(r, c);
-                if (piece.type != PieceType::EMPTY) {
-                    int basePieceValue = getPieceValue(piece.type);
-                    int pstValue = getPstValue(piece.type, r, c, piece.owner); // Uses updated getPstValue
-                    Player owner = piece.owner;
-                    Player opponent = (owner == Player::PLAYER1) ? Player::PLAYER2 : Player::PLAYER1;
-
-                    // Check if piece is in an opponent's trap for Trap Control Score
-                    bool isInOpponentTrap = gameState.isOwnTrap(r, c, opponent);
-                    int currentTrapAdjustment = 0;
-                    if (isInOpponentTrap) {
-                        int defenderCount = 0; int maxDefenderRank = 0; int maxSupportRank = 0;
-                        int adjacentOffsets[][2] = {{0, 1}, {0, -1}, {1, 0}, {-1, 0}};
-                        for (const auto& offset : adjacentOffsets) {
-                            int adj_r = r + offset[0]; int adj_c = c + offset[1];
-                            if (gameState.isValidPosition(adj_r, adj_c) && !gameState.isRiver(adj_r, adj_c)) {
-                                Piece adjPiece = gameState.getPiece(adj_r, adj_c);
-                                if (adjPiece.owner == opponent) { defenderCount++; maxDefenderRank = std::max(maxDefenderRank, gameState.getRank(adjPiece.type)); }
-                                else if (adjPiece.owner == owner) { maxSupportRank = std::max(maxSupportRank, gameState.getRank(adjPiece.type)); }
-                            }
-                        }
-                        // Apply logic based on defenders/supporters
-                        if (defenderCount >= 2) { currentTrapAdjustment = -(basePieceValue * TRAP_CONTROL_SUICIDE_PENALTY_PCT / 100); }
-                        else if (defenderCount == 1) {
-                            if (maxSupportRank > 0) { // Support exists
-                                if (maxSupportRank >= maxDefenderRank) { currentTrapAdjustment = TRAP_CONTROL_WINNING_BONUS; }
-                                else { currentTrapAdjustment = -(basePieceValue * 90 / 100); } // Supporter weaker
-                            } else { currentTrapAdjustment = -(basePieceValue * 90 / 100); } // No support
-                        } else { currentTrapAdjustment = TRAP_CONTROL_SAFE_BONUS; } // No defenders
-
-                        if (owner == Player::PLAYER2) { trapControlScore += currentTrapAdjustment; }
-                        else { trapControlScore -= currentTrapAdjustment; }
-                    } // End if isInOpponentTrap
-
-                    // --- Other Evaluation Terms ---
-                    if (owner == Player::PLAYER2) { // AI's piece
-                        materialScore += basePieceValue;
-                        positionalScorePST += pstValue;
-                        // Lion Proximity Bonus (Still keep this specific one? Maybe reduce weight?)
-                        if (piece.type == PieceType::LION) { lionProximityScore += LION_PROXIMITY_WEIGHT * (BOARD_ROWS - 1 - r); }
-                        else if (piece.type == PieceType::ELEPHANT) { aiElephantRow = r; aiElephantCol = c; }
-                        // Trapped Piece Malus (Near corner, diagonally blocked, NOT in trap)
-                        else if (!isInOpponentTrap && (piece.type == PieceType::LION || piece.type == PieceType::TIGER || piece.type == PieceType::ELEPHANT)) {
-                            int corner_r = 0; int corner_c = -1; int trap_r = r + 1; int trap_c = -1;
-                            if (c <= 3) { corner_c = 0; trap_c = c + 1; } else { corner_c = 6; trap_c = c - 1; }
-                            int dist = std::abs(r - corner_r) + std::abs(c - corner_c);
-                            if (dist <= 2) {
-                                if (gameState.isValidPosition(trap_r, trap_c)) {
-                                    Piece trapperPiece = gameState.getPiece(trap_r, trap_c);
-                                    if (trapperPiece.owner == Player::PLAYER1 && gameState.getRank(trapperPiece.type) >= gameState.getRank(piece.type)) {
-                                        double penalty_pct = 0.0;
-                                        if (dist == 0) penalty_pct = TRAPPED_CORNER_MALUS_PCT;
-                                        else if (dist == 1) penalty_pct = TRAPPED_DIST1_MALUS_PCT;
-                                        else if (dist == 2) penalty_pct = TRAPPED_DIST2_MALUS_PCT;
-                                        trappedPieceMalus -= static_cast<int>(basePieceValue * penalty_pct);
-                                    }
-                                }
-                            }
-                        }
-                        // Rat Intercept Bonus
-                        else if (piece.type == PieceType::RAT && !gameState.isRiver(r, c)) { /* ... Rat intercept logic ... */ }
-                        // Den Safety Threat (AI attacking opponent den)
-                        if (piece.type == PieceType::LION || piece.type == PieceType::TIGER || piece.type == PieceType::ELEPHANT || piece.type == PieceType::RAT) {
-                            int dist_to_opponent_den = std::abs(r - 0) + std::abs(c - 3);
-                            if (dist_to_opponent_den <= DEN_SAFETY_MAX_DIST) {
-                                ai_pieces_near_opponent_den++;
-                                int piece_threat = DEN_SAFETY_BASE_SCORE * (DEN_SAFETY_MAX_DIST - dist_to_opponent_den + 1);
-                                opponent_den_threat_score += piece_threat;
-                            }
-                        }
 
-                    } else { // Human's piece (Player::PLAYER1)
-                        materialScore -= basePieceValue;
-                        positionalScorePST -= pstValue;
-                        // Lion Proximity Penalty
-                        if (piece.type == PieceType::LION) { lionProximityScore += -LION_PROXIMITY_WEIGHT * r; }
-                        else if (piece.type == PieceType::RAT) { humanRatRow = r; humanRatCol = c; }
-                        // Den Safety Threat (Human attacking AI den)
-                        if (piece.type == PieceType::LION || piece.type == PieceType::TIGER || piece.type == PieceType::ELEPHANT || piece.type == PieceType::RAT) {
-                            int dist_to_ai_den = std::abs(r - (BOARD_ROWS - 1)) + std::abs(c - 3);
-                            if (dist_to_ai_den <= DEN_SAFETY_MAX_DIST) {
-                                opponent_pieces_near_ai_den++;
-                                int piece_threat = DEN_SAFETY_BASE_SCORE * (DEN_SAFETY_MAX_DIST - dist_to_ai_den + 1);
-                                ai_den_threat_score += piece_threat;
-                            }
+    // --- Den Safety Table ---
+    // Threat a Lion/Tiger/Elephant/Rat adds against the opposing den from each square:
+    // denSafetyBaseScore * (DEN_SAFETY_MAX_DIST - dist + 1) within DEN_SAFETY_MAX_DIST (Manhattan), else 0.
+    // GameState keeps per-side sums and counts (den-zone occupancy) of these.
+    constexpr MaterialPstTable buildDenThreatTable(const EvalParams& params) {
+        MaterialPstTable table{};
+        const PieceType threatTypes[] = {PieceType::LION, PieceType::TIGER, PieceType::ELEPHANT, PieceType::RAT};
+        for (PieceType type : threatTypes) {
+            for (int p = 1; p <= 2; ++p) {
+                int denRow = (static_cast<Player>(p) == Player::PLAYER2) ? 0 : (BOARD_ROWS - 1); // Opponent's den
+                for (int r = 0; r < BOARD_ROWS; ++r) {
+                    for (int c = 0; c < BOARD_COLS; ++c) {
+                        int dist = (r > denRow ? r - denRow : denRow - r) + (c > 3 ? c - 3 : 3 - c);
+                        if (dist <= DEN_SAFETY_MAX_DIST) {
+                            table[static_cast<int>(type)][p][r * BOARD_COLS + c] = params.denSafetyBaseScore * (DEN_SAFETY_MAX_DIST - dist + 1);
                         }
                     }
                 }
             }
         }
+        return table;
+    }
+
+    extern MaterialPstTable denThreatValue; // buildDenThreatTable(params)
+
+
+    // --- Trap Geometry ---
+    // The six trap squares, each with the player who owns it. A piece of the other side standing
+    // on one is an "intruder"; GameState keeps a bitmask (bit = index here) of occupied-by-intruder traps.
+    struct TrapSquare { int r; int c; Player owner; };
+    constexpr TrapSquare TRAP_SQUARES[6] = {
+        {0, 2, Player::PLAYER1}, {0, 4, Player::PLAYER1}, {1, 3, Player::PLAYER1},
+        {8, 2, Player::PLAYER2}, {8, 4, Player::PLAYER2}, {7, 3, Player::PLAYER2}
+    };
+
+    constexpr std::array<int8_t, BOARD_ROWS * BOARD_COLS> buildTrapIndexTable() {
+        std::array<int8_t, BOARD_ROWS * BOARD_COLS> table{};
+        for (auto& entry : table) entry = -1;
+        for (int i = 0; i < 6; ++i) table[TRAP_SQUARES[i].r * BOARD_COLS + TRAP_SQUARES[i].c] = static_cast<int8_t>(i);
+        return table;
+    }
+
+    inline constexpr std::array<int8_t, BOARD_ROWS * BOARD_COLS> trapIndexBySquare = buildTrapIndexTable(); // -1 if not a trap
+
+
+    // --- Trapped Corner Zone ---
+    // Squares within Manhattan distance 2 of the AI's (Player 2's) target corners (0,0)/(0,6),
+    // minus the traps, with the square a blocking Player 1 piece would stand on (diagonally ahead).
+    struct CornerZoneSquare { int r; int c; int dist; int blockerR; int blockerC; };
+    constexpr CornerZoneSquare CORNER_ZONE[10] = {
+        {0, 0, 0, 1, 1}, {0, 1, 1, 1, 2}, {1, 0, 1, 2, 1}, {1, 1, 2, 2, 2}, {2, 0, 2, 3, 1},
+        {0, 6, 0, 1, 5}, {0, 5, 1, 1, 4}, {1, 6, 1, 2, 5}, {1, 5, 2, 2, 4}, {2, 6, 2, 3, 5}
+    };
+
+
+    // --- Rat / Elephant Geometry Tables ---
+    // Both terms scale linearly with the rat's step distance d: full weight at d = 0 (d = 1 for the
+    // elephant, which the rat can't share a square with), zero beyond RAT_PROXIMITY_THRESHOLD.
+    // A rat in the river counts one extra step towards a land target (it must come out first).
+    // elephantTrapValue[ratSq][elephantSq]: danger to an elephant within ELEPHANT_EDGE_THRESHOLD of
+    //   the board edge (few escape squares) from the opposing rat.
+    // ratInterceptValue[ratSq][lane]: value of a rat in, or near, a river lane (Bitboard::RIVER_LANES)
+    //   that an opposing Lion/Tiger could jump across.
+    using RatSquareTable = std::array<std::array<int16_t, Bitboard::NUM_SQUARES>, Bitboard::NUM_SQUARES>;
+    using RatLaneTable = std::array<std::array<int16_t, Bitboard::NUM_RIVER_LANES>, Bitboard::NUM_SQUARES>;
+
+    constexpr int scaleByRatDistance(int maxValue, int dist) {
+        return dist > RAT_PROXIMITY_THRESHOLD ? 0 : maxValue * (RAT_PROXIMITY_THRESHOLD + 1 - dist) / (RAT_PROXIMITY_THRESHOLD + 1);
+    }
+
+    constexpr RatSquareTable buildElephantTrapTable(const EvalParams& params) {
+        RatSquareTable table{};
+        for (int ratSq = 0; ratSq < Bitboard::NUM_SQUARES; ++ratSq) {
+            int rr = ratSq / BOARD_COLS, rc = ratSq % BOARD_COLS;
+            for (int eSq = 0; eSq < Bitboard::NUM_SQUARES; ++eSq) {
+                int er = eSq / BOARD_COLS, ec = eSq % BOARD_COLS;
+                int edgeDist = std::min(std::min(er, BOARD_ROWS - 1 - er), std::min(ec, BOARD_COLS - 1 - ec));
+                if (ratSq == eSq || edgeDist > ELEPHANT_EDGE_THRESHOLD) continue;
+                int dist = (rr > er ? rr - er : er - rr) + (rc > ec ? rc - ec : ec - rc);
+                if (Bitboard::isRiverSquare(rr, rc)) dist += 1;
+                table[ratSq][eSq] = static_cast<int16_t>(scaleByRatDistance(params.elephantTrapPenalty, dist));
+            }
+        }
+        return table;
+    }
+
+    constexpr RatLaneTable buildRatInterceptTable(const EvalParams& params) {
+        RatLaneTable table{};
+        for (int ratSq = 0; ratSq < Bitboard::NUM_SQUARES; ++ratSq) {
+            int rr = ratSq / BOARD_COLS, rc = ratSq % BOARD_COLS;
+            for (int lane = 0; lane < Bitboard::NUM_RIVER_LANES; ++lane) {
+                int dist = BOARD_ROWS + BOARD_COLS;
+                for (int sq = 0; sq < Bitboard::NUM_SQUARES; ++sq) {
+                    if (!(Bitboard::RIVER_LANES[lane] & (1ULL << sq))) continue;
+                    int lr = sq / BOARD_COLS, lc = sq % BOARD_COLS;
+                    dist = std::min(dist, (rr > lr ? rr - lr : lr - rr) + (rc > lc ? rc - lc : lc - rc));
+                }
+                table[ratSq][lane] = static_cast<int16_t>(scaleByRatDistance(params.ratInterceptMaxBonus, dist));
+            }
+        }
+        return table;
+    }
+
+    extern RatSquareTable elephantTrapValue; // buildElephantTrapTable(params)
+    extern RatLaneTable ratInterceptValue;   // buildRatInterceptTable(params)
+
+    // Danger to Us's elephant from the opposing rat (0 if either is gone)
+    template <Player Us>
+    inline int elephantTrapRisk(const GameState& gameState) {
+        uint64_t elephant = gameState.getPieceBitboard(PieceType::ELEPHANT, Us);
+        uint64_t rat = gameState.getPieceBitboard(PieceType::RAT, opponentOf(Us));
+        if (!elephant || !rat) return 0;
+        return elephantTrapValue[Bitboard::lowestSquare(rat)][Bitboard::lowestSquare(elephant)];
+    }
+
+    // Us's rat guarding the best river lane next to an opposing Lion/Tiger (0 if none)
+    template <Player Us>
+    inline int ratInterceptScore(const GameState& gameState) {
+        constexpr Player Them = opponentOf(Us);
+        uint64_t rat = gameState.getPieceBitboard(PieceType::RAT, Us);
+        uint64_t jumpers = gameState.getPieceBitboard(PieceType::LION, Them) | gameState.getPieceBitboard(PieceType::TIGER, Them);
+        if (!rat || !jumpers) return 0;
+        const auto& ratRow = ratInterceptValue[Bitboard::lowestSquare(rat)];
+        int best = 0;
+        while (jumpers) {
+            int sq = Bitboard::lowestSquare(jumpers); jumpers &= jumpers - 1;
+            for (const Bitboard::JumpLane& lane : Bitboard::jumpLanes[sq]) {
+                if (lane.lane >= 0) best = std::max(best, static_cast<int>(ratRow[lane.lane]));
+            }
+        }
+        return best;
+    }
+
+
+    // --- Structure-of-Arrays Board Kernel ---
+    // One 64-byte plane per attribute (square = r * BOARD_COLS + c, square 63 is padding/empty).
+    // computeBoardTerms() rebuilds the per-side incremental terms from scratch over all squares
+    // at once, with an AVX2 gather kernel picked at runtime and a scalar fallback (see Evaluation.cpp).
+    constexpr int PLANE_SIZE = 64;
+    struct alignas(64) BoardPlanes {
+        int8_t type[PLANE_SIZE];     // PieceType
+        int8_t owner[PLANE_SIZE];    // Player
+        int8_t weakened[PLANE_SIZE]; // 0/1
+    };
+
+    struct BoardTerms {
+        int materialPst[3] = {0, 0, 0}; // Indexed by Player (NONE slot unused)
+        int denThreat[3] = {0, 0, 0};
+        int denZoneCount[3] = {0, 0, 0};
+    };
+
+    void fillBoardPlanes(const std::vector<std::vector<Piece>>& board, BoardPlanes& planes);
+    BoardTerms computeBoardTerms(const BoardPlanes& planes);
+    // The two kernels behind computeBoardTerms(), for benchmarks and cross-checks.
+    // computeBoardTermsAVX2() returns false (terms untouched) if this build or CPU has no AVX2.
+    BoardTerms computeBoardTermsScalar(const BoardPlanes& planes);
+    bool computeBoardTermsAVX2(const BoardPlanes& planes, BoardTerms& terms);
+
+
+    // --- Bitboard Mobility / Capture Threats ---
+    // Set-wise over GameState's bitboards: one shift-and-mask step set per piece type
+    // (plus jump lanes for Lion/Tiger), popcounted. mobility equals getAllLegalMoves(us).size();
+    // threatenedValue sums getPieceValue() of every opponent piece that has a legal capture on it.
+    // Templated on the side so the den/trap masks and bitboard slots are compile-time constants.
+    struct SideActivity { int mobility = 0; int threatenedValue = 0; };
+
+    template <Player Us>
+    inline SideActivity computeSideActivity(const GameState& gameState) {
+        using namespace Bitboard;
+        constexpr Player Them = opponentOf(Us);
+        constexpr uint64_t OUR_DEN = denMask(Us);
+        constexpr uint64_t OUR_TRAPS = trapMask(Us);
+        uint64_t own = gameState.getOccupancy(Us);
+        uint64_t theirs = gameState.getOccupancy(Them);
+        uint64_t occupied = own | theirs;
+        uint64_t allowed = ALL_SQUARES & ~own & ~OUR_DEN;
+        // Trap rule / permanent weakening: any of our pieces may take these
+        uint64_t alwaysCapturable = theirs & (OUR_TRAPS | gameState.getWeakenedBitboard(Them));
+
+        // theirsUpToRank[k] = their pieces of rank <= k (PieceType value == rank)
+        uint64_t theirsByType[9] = {0};
+        uint64_t theirsUpToRank[9] = {0};
+        for (int t = 1; t <= 8; ++t) {
+            theirsByType[t] = gameState.getPieceBitboard(static_cast<PieceType>(t), Them);
+            theirsUpToRank[t] = theirsUpToRank[t - 1] | theirsByType[t];
+        }
+
+        SideActivity activity;
+        uint64_t threatened = 0;
+        for (int t = 1; t <= 8; ++t) {
+            PieceType type = static_cast<PieceType>(t);
+            uint64_t pieces = gameState.getPieceBitboard(type, Us);
+            if (!pieces) continue;
+            uint64_t targets, captures;
+            if (type == PieceType::RAT) {
+                // Rat may swim, but only captures within its own medium (land->land, river->river)
+                targets = stepTargets(pieces) & allowed;
+                uint64_t reach = (stepTargets(pieces & LAND) & LAND) | (stepTargets(pieces & RIVER) & RIVER);
+                captures = reach & targets & (theirsUpToRank[1] | theirsByType[8] | alwaysCapturable);
+            } else {
+                targets = stepTargets(pieces) & LAND & allowed;
+                if (type == PieceType::LION || type == PieceType::TIGER) targets |= jumpTargets(pieces, occupied) & allowed;
+                uint64_t capturable = theirsUpToRank[t];
+                if (type == PieceType::ELEPHANT) capturable &= ~theirsByType[1]; // Elephant cannot take the Rat
+                captures = targets & (capturable | alwaysCapturable);
+            }
+            activity.mobility += popcount((targets & ~occupied) | captures); // Quiet moves + legal captures
+            threatened |= captures;
+        }
+        for (int t = 1; threatened && t <= 8; ++t) {
+            uint64_t hit = theirsByType[t] & threatened;
+            if (hit) activity.threatenedValue += popcount(hit) * getPieceValue(static_cast<PieceType>(t));
+        }
+        return activity;
+    }
+
+
+    // --- Cheap Tier: Material + PST ---
+    // Precombined in GameState's running accumulators, so this is two loads
+    inline int evaluateMaterialPst(const GameState& gameState) {
+        return gameState.getMaterialPst(Player::PLAYER2) - gameState.getMaterialPst(Player::PLAYER1);
+    }
+
+    // --- Expensive Tier: Positional Terms ---
+    // Everything except material/PST. Combines GameState's incremental terms; only the (usually
+    // empty) trap intruders and the ten corner-zone squares are looked at directly.
+    inline int evaluatePositionalTerms(const GameState& gameState) {
+        int elephantTrapPenalty = 0;
+        int trappedPieceMalus = 0; int ratInterceptBonus = 0;
+        int trapControlScore = 0;
+
+        // --- Trap Control (only traps currently holding an opponent piece) ---
+        unsigned intruderMask = gameState.getTrapIntruderMask();
+        for (int i = 0; intruderMask != 0; ++i, intruderMask >>= 1) {
+            if (!(intruderMask & 1u)) continue;
+            int r = TRAP_SQUARES[i].r; int c = TRAP_SQUARES[i].c;
+            Player opponent = TRAP_SQUARES[i].owner; // Trap owner defends
+            Piece piece = gameState.getPiece(r, c);
+            Player owner = piece.owner;
+            int basePieceValue = getPieceValue(piece.type);
+            int currentTrapAdjustment = 0;
+
+            int defenderCount = 0; int maxDefenderRank = 0; int maxSupportRank = 0;
+            int adjacentOffsets[][2] = {{0, 1}, {0, -1}, {1, 0}, {-1, 0}};
+            for (const auto& offset : adjacentOffsets) {
+                int adj_r = r + offset[0]; int adj_c = c + offset[1];
+                if (gameState.isValidPosition(adj_r, adj_c) && !gameState.isRiver(adj_r, adj_c)) {
+                    Piece adjPiece = gameState.getPiece(adj_r, adj_c);
+                    if (adjPiece.owner == opponent) { defenderCount++; maxDefenderRank = std::max(maxDefenderRank, gameState.getRank(adjPiece.type)); }
+                    else if (adjPiece.owner == owner) { maxSupportRank = std::max(maxSupportRank, gameState.getRank(adjPiece.type)); }
+                }
+            }
+            // Apply logic based on defenders/supporters
+            if (defenderCount >= 2) { currentTrapAdjustment = -(basePieceValue * params.trapControlSuicidePenaltyPct / 100); }
+            else if (defenderCount == 1) {
+                if (maxSupportRank > 0) { // Support exists
+                    if (maxSupportRank >= maxDefenderRank) { currentTrapAdjustment = params.trapControlWinningBonus; }
+                    else { currentTrapAdjustment = -(basePieceValue * params.trapControlLosingPenaltyPct / 100); } // Supporter weaker
+                } else { currentTrapAdjustment = -(basePieceValue * params.trapControlLosingPenaltyPct / 100); } // No support
+            } else { currentTrapAdjustment = params.trapControlSafeBonus; } // No defenders
+
+            if (owner == Player::PLAYER2) { trapControlScore += currentTrapAdjustment; }
+            else { trapControlScore -= currentTrapAdjustment; }
+        }
 
-        // --- Mobility Score (COMMENTED OUT FOR PERFORMANCE) ---
-        // int aiMoves = gameState.getAllLegalMoves(Player::PLAYER2).size();
-        // int humanMoves = gameState.getAllLegalMoves(Player::PLAYER1).size();
-        // int mobilityScore = MOBILITY_WEIGHT * (aiMoves - humanMoves);
+        // --- Trapped Piece Malus (AI piece near corner, diagonally blocked, NOT in trap) ---
+        // Only the Tiger is checked: Lion and Elephant were always routed to their own
+        // branches first in the original per-piece chain, so they never received this malus.
+        for (const auto& sq : CORNER_ZONE) {
+            Piece piece = gameState.getPiece(sq.r, sq.c);
+            if (piece.owner != Player::PLAYER2 || piece.type != PieceType::TIGER) continue;
+            Piece trapperPiece = gameState.getPiece(sq.blockerR, sq.blockerC);
+            if (trapperPiece.owner == Player::PLAYER1 && gameState.getRank(trapperPiece.type) >= gameState.getRank(piece.type)) {
+                double penalty_pct = 0.0;
+                if (sq.dist == 0) penalty_pct = params.trappedCornerMalusPct;
+                else if (sq.dist == 1) penalty_pct = params.trappedDist1MalusPct;
+                else if (sq.dist == 2) penalty_pct = params.trappedDist2MalusPct;
+                trappedPieceMalus -= static_cast<int>(getPieceValue(piece.type) * penalty_pct);
+            }
+        }
+
+        // --- Rat Intercept Bonus / Elephant Trap Penalty (precomputed geometry tables) ---
+        elephantTrapPenalty = elephantTrapRisk<Player::PLAYER1>(gameState) - elephantTrapRisk<Player::PLAYER2>(gameState);
+        ratInterceptBonus = ratInterceptScore<Player::PLAYER2>(gameState) - ratInterceptScore<Player::PLAYER1>(gameState);
 
-        // --- Elephant Trap Penalty Calculation ---
-        if (aiElephantRow != -1 && humanRatRow != -1) { /* ... elephant trap logic ... */ }
+        // --- Mobility and Capture Threats (bitboard popcounts) ---
+        SideActivity aiActivity = computeSideActivity<Player::PLAYER2>(gameState);
+        SideActivity humanActivity = computeSideActivity<Player::PLAYER1>(gameState);
+        int mobilityScore = params.mobilityWeight * (aiActivity.mobility - humanActivity.mobility);
+        int captureThreatScore = (aiActivity.threatenedValue - humanActivity.threatenedValue) * params.captureThreatPct / 100;
 
-        // --- Scale Den Threat Scores by Count ---
-        if (opponent_pieces_near_ai_den > 1) { ai_den_threat_score = static_cast<int>(ai_den_threat_score * (1.0 + DEN_SAFETY_COUNT_MULTIPLIER * (opponent_pieces_near_ai_den - 1))); }
-        if (ai_pieces_near_opponent_den > 1) { opponent_den_threat_score = static_cast<int>(opponent_den_threat_score * (1.0 + DEN_SAFETY_COUNT_MULTIPLIER * (ai_pieces_near_opponent_den - 1))); }
+        // --- Den Safety (incremental sums), Scaled by Count ---
+        int ai_den_threat_score = gameState.getDenThreat(Player::PLAYER1);       // Human attacking AI den
+        int opponent_den_threat_score = gameState.getDenThreat(Player::PLAYER2); // AI attacking opponent den
+        int opponent_pieces_near_ai_den = gameState.getDenZoneCount(Player::PLAYER1);
+        int ai_pieces_near_opponent_den = gameState.getDenZoneCount(Player::PLAYER2);
+        if (opponent_pieces_near_ai_den > 1) { ai_den_threat_score = static_cast<int>(ai_den_threat_score * (1.0 + params.denSafetyCountMultiplier * (opponent_pieces_near_ai_den - 1))); }
+        if (ai_pieces_near_opponent_den > 1) { opponent_den_threat_score = static_cast<int>(opponent_den_threat_score * (1.0 + params.denSafetyCountMultiplier * (ai_pieces_near_opponent_den - 1))); }
 
 
         // --- Combine Scores ---
-        return (materialScore * MATERIAL_WEIGHT_MULTIPLIER)
-               + positionalScorePST // Now includes separate L/T values
-               // + mobilityScore // COMMENTED OUT FOR PERFORMANCE
-               // + lionProximityScore // Maybe remove this now PSTs are stronger? Keep for now.
+        return mobilityScore
+               + captureThreatScore
                + elephantTrapPenalty
                + trappedPieceMalus
                + ratInterceptBonus
@@ -272,6 +392,40 @@ namespace Evaluation {
                - ai_den_threat_score;      // Den Safety penalty for Human
     }
 
+    // --- Static Board Evaluation Function ---
+    inline int evaluateBoard(const GameState& gameState) {
+        if (NNUE::isActive()) return NNUE::evaluate(gameState); // --eval nnue
+        return evaluateMaterialPst(gameState) // Weighted material + PST (separate L/T values)
+               + evaluatePositionalTerms(gameState);
+    }
+
+    // --- Lazy Evaluation ---
+    // Skips the positional terms when the cheap tier is outside [alpha, beta] by more than
+    // margin: they can't bring it back into the window (see SearchParams::lazyEvalMargin),
+    // so the search gets the same cutoff for less work. The score returned then is the bound
+    // the margin guarantees (cheap + margin on a fail low, cheap - margin on a fail high), not
+    // the cheap tier itself, so a fail-soft search never stores a bound tighter than the truth.
+    // lazyExit tells the caller the score is only a bound (don't cache it as exact).
+    inline int evaluateBoardLazy(const GameState& gameState, int alpha, int beta, int margin, bool& lazyExit) {
+        lazyExit = false;
+        if (NNUE::isActive()) return NNUE::evaluate(gameState); // Already a single cheap pass
+        int materialPstScore = evaluateMaterialPst(gameState);
+        if (materialPstScore + margin <= alpha) { lazyExit = true; return materialPstScore + margin; } // Upper bound, still <= alpha
+        if (materialPstScore - margin >= beta) { lazyExit = true; return materialPstScore - margin; }  // Lower bound, still >= beta
+        return materialPstScore + evaluatePositionalTerms(gameState);
+    }
+
+    // --- Batch Evaluation ---
+    // Evaluates count positions into scores[0..count). Large batches are split across threads
+    // (maxThreads = 0 uses all hardware threads), at least BATCH_MIN_POSITIONS_PER_THREAD each;
+    // results equal evaluateBoard() per position.
+    constexpr size_t BATCH_MIN_POSITIONS_PER_THREAD = 16384; // Below this, thread start-up costs more than it saves
+    void evaluateBatch(const GameState* states, size_t count, int* scores, unsigned maxThreads = 0);
+    inline void evaluateBatch(const std::vector<GameState>& states, std::vector<int>& scores, unsigned maxThreads = 0) {
+        scores.resize(states.size());
+        evaluateBatch(states.data(), states.size(), scores.data(), maxThreads);
+    }
+
 } // namespace Evaluation
 
 
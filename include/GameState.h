@@ -2,9 +2,12 @@
 
 #include "Common.h"
 #include "Hashing.h"
+#include "NNUE.h"
+#include <array>
 #include <vector>
 #include <cstdint>
 #include <map> // For piece counting
+#include <string>
 
 class GameState {
 public:
@@ -26,6 +29,29 @@ public:
 
     // --- Hashing ---
     uint64_t getHashKey() const;
+    // Hash of the position after applyMove(move) + switchPlayer(), computed from the
+    // Zobrist deltas without touching the board (used to prefetch TT entries early)
+    uint64_t getHashKeyAfterMove(const Move& move) const;
+    // getHashKey() with both players' weakened bitboards mixed in (equal to it while nothing is
+    // weakened). The Zobrist key leaves the permanent 'weakened' flag out, so caches whose value
+    // depends on it (evaluation, perft counts) key on this instead.
+    uint64_t getHashKeyWithWeakened() const;
+
+    // --- Incremental Evaluation Terms ---
+    // Running sum of Evaluation::materialPstValue over the player's pieces (O(1) read for the evaluator)
+    int getMaterialPst(Player player) const;
+    // Sum of Evaluation::denThreatValue over the player's pieces, and how many of them are in the den zone
+    int getDenThreat(Player player) const;
+    int getDenZoneCount(Player player) const;
+    // Bit i set if Evaluation::TRAP_SQUARES[i] is occupied by a piece of the trap owner's opponent
+    unsigned getTrapIntruderMask() const;
+    // First-layer NNUE accumulator (only maintained while NNUE::isActive(), see NNUE::Accumulator)
+    const NNUE::Accumulator& getNnueAccumulator() const;
+    // Bitboards (bit r * BOARD_COLS + c, see Bitboard.h) kept alongside the board.
+    // Defined inline: the evaluator reads a few dozen of these per leaf.
+    uint64_t getPieceBitboard(PieceType type, Player player) const { return pieceBitboards[Zobrist::getPiecePlayerIndex(type, player)]; }
+    uint64_t getOccupancy(Player player) const { return occupancyBitboards[static_cast<int>(player)]; }
+    uint64_t getWeakenedBitboard(Player player) const { return weakenedBitboards[static_cast<int>(player)]; }
 
     // --- Public Helper Functions ---
     bool isValidPosition(int r, int c) const;
@@ -39,6 +65,20 @@ public:
     void setCurrentPlayer(Player player);
     void setHashKey(uint64_t key);
 
+    // --- Position Notation ---
+    // One line, FEN-like: ranks 9..1 (row 8 first) separated by '/', digits = runs of empty squares,
+    // r c d w p t l e = Rat Cat Dog Wolf Leopard Tiger Lion Elephant (upper case = Player 1),
+    // '*' after a piece = weakened; then a space and the side to move (1|2).
+    // Start position: "t5l/1c3d1/e1w1p1r/7/7/7/R1P1W1E/1D3C1/L5T 1"
+    static const size_t MAX_NOTATION_LENGTH = 2 * BOARD_ROWS * BOARD_COLS + BOARD_ROWS + 2; // Excluding the NUL
+    // Both are allocation-free. toNotation writes a NUL-terminated string and returns its length
+    // (0 if bufferSize is too small); fromNotation reads up to the first char after the side to move
+    // and leaves the state untouched (returning false) if the text is malformed or the position is
+    // impossible (a second piece of a type for one side, a non-Rat in the river, a piece in its own den).
+    size_t toNotation(char* buffer, size_t bufferSize) const;
+    bool fromNotation(const char* text, const char** end = nullptr);
+    std::string toNotation() const;
+
     // --- Methods for Setup Mode ---
     bool setPieceAt(int r, int c, PieceType type, Player player);
     void clearSquare(int r, int c);
@@ -53,10 +93,22 @@ private:
     std::vector<std::vector<Piece>> board; // <<< Still private
     Player currentPlayer;
     uint64_t currentHashKey;
+    int materialPst[3] = {0, 0, 0}; // Indexed by Player (NONE slot unused)
+    int denThreat[3] = {0, 0, 0};
+    int denZoneCount[3] = {0, 0, 0};
+    unsigned trapIntruderMask = 0;
+    NNUE::Accumulator nnueAccumulator;
+    uint64_t pieceBitboards[Zobrist::NUM_PIECE_PLAYER_KINDS] = {}; // Indexed like the Zobrist piece-player kinds
+    uint64_t occupancyBitboards[3] = {0, 0, 0};
+    uint64_t weakenedBitboards[3] = {0, 0, 0};
 
     // --- Private Helper Functions ---
     bool canCapture(const Piece& attacker, const Piece& defender, int defenderRow, int defenderCol) const;
     void updateHashForPieceChange(PieceType type, Player player, int r, int c);
+    // Adds (sign = +1) or removes (sign = -1) a piece's contribution to the incremental eval terms
+    void updateEvalTermsForPieceChange(const Piece& piece, int r, int c, int sign);
+    void recalculateEvalTerms();
+    void rebuildNnueAccumulator();
 };
 
 
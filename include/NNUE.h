@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Common.h"
+#include <array>
+#include <cstdint>
+#include <string>
+
+class GameState; // Forward declaration (GameState owns the accumulator)
+
+// Efficiently-updatable neural network evaluator (optional, selected with --eval nnue).
+//
+// Network: INPUT_SIZE sparse binary features -> HIDDEN_SIZE int16 accumulator
+//          -> clipped ReLU [0, 127] -> int8 output weights -> int32 -> score.
+// The accumulator lives in GameState and is updated incrementally in applyMove() while a network
+// is loaded, so a leaf evaluation is just the output layer (one AVX2 pass over HIDDEN_SIZE bytes).
+namespace NNUE {
+
+    // --- Network Dimensions ---
+    constexpr int NUM_PIECE_KINDS = 18; // Zobrist piece-player index (PieceType * 2 + PlayerOffset)
+    constexpr int NUM_SQUARES = BOARD_ROWS * BOARD_COLS;
+    constexpr int WEAKENED_FEATURE_BASE = NUM_PIECE_KINDS * NUM_SQUARES; // Then 2 players x 63 squares
+    constexpr int INPUT_SIZE = WEAKENED_FEATURE_BASE + 2 * NUM_SQUARES;  // 1260
+    constexpr int HIDDEN_SIZE = 128;
+    constexpr int CLIPPED_RELU_MAX = 127;
+
+    // --- Weights File Format (little-endian) ---
+    // char magic[8] = "JCNNUE01"; uint32 version; uint32 inputSize; uint32 hiddenSize;
+    // int32 outputScale (score = output * outputScale / 1024, from Player 2's view like evaluateBoard)
+    // int16 featureBias[HIDDEN_SIZE]; int16 featureWeights[INPUT_SIZE][HIDDEN_SIZE];
+    // int8 outputWeights[HIDDEN_SIZE]; int32 outputBias
+    bool load(const std::string& filename);
+
+    // True once a network is loaded; evaluateBoard() then delegates to evaluate()
+    extern bool active;
+    inline bool isActive() { return active; }
+    // Id of the loaded network (0 = none), bumped by every successful load()
+    extern uint32_t network;
+
+    // --- Accumulator ---
+    // First-layer sums plus the network they were built for. Copies only carry the values while
+    // they belong to the loaded network, so copy-make under the classic evaluator doesn't pay
+    // for them; a state built before load() is stale and gets rebuilt on its next move.
+    struct Accumulator {
+        alignas(32) std::array<int16_t, HIDDEN_SIZE> values;
+        uint32_t builtFor = 0; // NNUE::network at the last rebuild (0 = never built)
+
+        Accumulator() = default;
+        Accumulator(const Accumulator& other) : builtFor(other.builtFor) { if (isCurrent()) values = other.values; }
+        Accumulator& operator=(const Accumulator& other) {
+            builtFor = other.builtFor;
+            if (isCurrent()) values = other.values;
+            return *this;
+        }
+        bool isCurrent() const { return builtFor != 0 && builtFor == network; }
+    };
+
+    // --- Feature Indexing ---
+    inline int pieceFeature(PieceType type, Player player, int square) {
+        return (static_cast<int>(type) * 2 + (player == Player::PLAYER1 ? 0 : 1)) * NUM_SQUARES + square;
+    }
+    inline int weakenedFeature(Player player, int square) {
+        return WEAKENED_FEATURE_BASE + (player == Player::PLAYER1 ? 0 : NUM_SQUARES) + square;
+    }
+
+    // --- Accumulator Maintenance ---
+    void resetAccumulator(int16_t* accumulator);                          // Accumulator = feature bias
+    void updateAccumulator(int16_t* accumulator, int feature, int sign);  // +/- one feature's weight row
+    void buildAccumulator(const GameState& gameState, int16_t* accumulator); // Bias plus every active feature
+
+    // --- Evaluation ---
+    int evaluate(const GameState& gameState);
+
+} // namespace NNUE
@@ -0,0 +1,21 @@
+#pragma once
+
+// --- Tunable Search Parameters ---
+// Search constants that can be changed at runtime (Engine::setSearchParams, selfplay --a/--b);
+// the SPSA tool (src/Spsa.cpp) tunes the ones whose benefit shows at a fixed node count.
+// The defaults live in the generated TunedSearchParams.h.
+struct SearchParams {
+    // Lazy eval: skip the positional terms when material + PST is this far outside [alpha, beta].
+    // Hand calibration: |evaluatePositionalTerms| stayed below 8500 in 99.9% of 400k random-game positions.
+    int lazyEvalMargin;
+    int captureVictimWeight;   // Move ordering: captures score victim value * this ...
+    int captureAttackerWeight; // ... minus attacker value * this (MVV-LVA)
+};
+
+// Name -> field, for command-line overrides (selfplay --a/--b); declaration order
+struct SearchParamField { const char* name; int SearchParams::*field; };
+inline constexpr SearchParamField SEARCH_PARAM_FIELDS[] = {
+    {"lazyEvalMargin",        &SearchParams::lazyEvalMargin},
+    {"captureVictimWeight",   &SearchParams::captureVictimWeight},
+    {"captureAttackerWeight", &SearchParams::captureAttackerWeight},
+};
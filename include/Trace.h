@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <chrono>
+
+// --- Control Macro for Tracing ---
+// Comment out this line to compile every TRACE_* point out (Trace::start() then reports it's unavailable)
+#define USE_TRACING
+
+// Timeline tracing in Chrome Trace Event format (open the file in https://ui.perfetto.dev or chrome://tracing).
+//
+// A TRACE_SCOPE records one complete event ("ph":"X") from construction to destruction into the
+// calling thread's ring buffer; nothing is shared between threads while recording, and a full
+// buffer overwrites its oldest events. Until Trace::start() a scope costs one relaxed atomic load.
+// Trace points are meant for coarse work (search iterations, root moves, book lookups, file I/O,
+// frames), not for every search node.
+namespace Trace {
+
+    constexpr size_t DEFAULT_EVENTS_PER_THREAD = 1 << 16; // 64 bytes each
+
+    // Starts recording (clears earlier events). Returns false if tracing is compiled out.
+    bool start(size_t eventsPerThread = DEFAULT_EVENTS_PER_THREAD);
+    void stop();
+    bool isEnabled();
+
+    // Names the calling thread in the trace viewer (string is copied)
+    void setThreadName(const std::string& name);
+
+    // Writes all recorded events. Call after stop(), or while no traced work is running.
+    bool writeJson(const std::string& filename);
+
+    // --- Scoped Event ---
+    // name/category must be string literals (only the pointers are stored).
+    class Scope {
+    public:
+        Scope(const char* name, const char* category);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        bool active() const { return startNs >= 0; }
+        void setArg(const char* key, int64_t value) { argKey = key; argValue = value; }
+        void setDetail(const std::string& text); // Shown as args.detail, up to 15 characters
+
+    private:
+        const char* name;
+        const char* category;
+        int64_t startNs = -1; // -1 = tracing was off at construction
+        const char* argKey = nullptr;
+        int64_t argValue = 0;
+        char detail[16] = {};
+    };
+
+} // namespace Trace
+
+#ifdef USE_TRACING
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+// Anonymous scope for the rest of the enclosing block
+#define TRACE_SCOPE(name, category) Trace::Scope TRACE_CONCAT(traceScope_, __LINE__)(name, category)
+// Named scope, for TRACE_ARG/TRACE_DETAIL below
+#define TRACE_SCOPE_NAMED(var, name, category) Trace::Scope var(name, category)
+#define TRACE_ARG(var, key, value) do { if ((var).active()) (var).setArg(key, value); } while (0)
+// text is only evaluated while tracing
+#define TRACE_DETAIL(var, text) do { if ((var).active()) (var).setDetail(text); } while (0)
+#else
+#define TRACE_SCOPE(name, category) ((void)0)
+#define TRACE_SCOPE_NAMED(var, name, category) ((void)0)
+#define TRACE_ARG(var, key, value) ((void)0)
+#define TRACE_DETAIL(var, text) ((void)0)
+#endif // USE_TRACING
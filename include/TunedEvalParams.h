@@ -0,0 +1,71 @@
+#pragma once
+// Evaluation parameter defaults. This file is (re)generated by the tune tool (src/Tune.cpp);
+// hand edits are fine, but a tuning run writes a complete new copy.
+
+#include "EvalParams.h"
+
+namespace Evaluation {
+
+    inline constexpr EvalParams DEFAULT_EVAL_PARAMS = {
+        // pieceValue: EMPTY, RAT, CAT, DOG, WOLF, LEOPARD, TIGER, LION, ELEPHANT
+        {{0, 6500, 3000, 4000, 5000, 6000, 7500, 8500, 9000}},
+        {{
+            // PST_RAT: Encourage river, advancing
+            {{
+                {{-5,-5, 0, 0, 0,-5,-5}}, {{ 0, 0, 5, 5, 5, 0, 0}}, {{ 5, 5,10,10,10, 5, 5}},
+                {{10,50,50,15,50,50,10}}, {{15,60,60,20,60,60,15}}, {{10,50,50,15,50,50,10}},
+                {{ 5,10,15,20,15,10, 5}}, {{ 0, 5,10,15,10, 5, 0}}, {{ 0, 0, 5,10, 5, 0, 0}}
+            }},
+            // PST_CAT_DOG: Encourage staying near own traps/den
+            {{
+                {{15,10,20,25,20,10,15}}, {{10,15,15,20,15,15,10}}, {{ 5, 5, 5, 5, 5, 5, 5}},
+                {{ 0, 0, 0, 0, 0, 0, 0}}, {{-5,-5,-5,-5,-5,-5,-5}}, {{-5,-5,-5,-5,-5,-5,-5}},
+                {{-10,-10,-5,-5,-5,-10,-10}}, {{-10,-10,-10,-10,-10,-10,-10}}, {{-15,-15,-10,-10,-10,-15,-15}}
+            }},
+            // PST_WOLF: Defensive posture
+            {{
+                {{ 5, 5, 5, 5, 5, 5, 5}}, {{10,10,10,10,10,10,10}}, {{15,15,15,15,15,15,15}},
+                {{ 5, 5, 5, 5, 5, 5, 5}}, {{ 0, 0, 0, 0, 0, 0, 0}}, {{-5,-5,-5,-5,-5,-5,-5}},
+                {{-10,-10,-10,-10,-10,-10,-10}}, {{-15,-15,-15,-15,-15,-15,-15}}, {{-20,-20,-15,-15,-15,-20,-20}}
+            }},
+            // PST_LEOPARD: Encourage advancing, central control
+            {{
+                {{ 0, 0, 0, 0, 0, 0, 0}}, {{ 0, 5, 5, 5, 5, 5, 0}}, {{ 0, 5,10,10,10, 5, 0}},
+                {{ 5,10,15,15,15,10, 5}}, {{ 5,10,15,15,15,10, 5}}, {{10,15,20,20,20,15,10}},
+                {{10,15,20,25,20,15,10}}, {{ 5,10,15,20,15,10, 5}}, {{ 0, 5,10,15,10, 5, 0}}
+            }},
+            // PST_TIGER: Strong but less den-focused than Lion
+            {{
+                {{-10,-10,-10, -1,-10,-10,-10}}, {{ -5, -5, -5, -5, -5, -5, -5}}, {{  0,  0,  5,  5,  5,  0,  0}},
+                {{  5, -1, -1, 20, -1, -1,  5}}, {{ 10, -1, -1, 25, -1, -1, 10}}, {{ 20, -1, -1,100, -1, -1, 20}},
+                {{ 25, 40, 95,200, 95, 40, 25}}, {{ 40, 80,230,450,230, 80, 40}}, {{  0,100,400,999,400,100,  0}}
+            }},
+            // PST_LION: Strong den attack values (row 8 = opponent back rank, den at [8][3])
+            {{
+                {{-10,-10,-10, -1,-10,-10,-10}}, {{ -5, -5, -5, -5, -5, -5, -5}}, {{  0,  0,  5,  5,  5,  0,  0}},
+                {{  5, -1, -1, 20, -1, -1,  5}}, {{ 10, -1, -1, 25, -1, -1, 10}}, {{ 15, -1, -1, 90, -1, -1, 15}},
+                {{ 20, 30,100,220,100, 30, 20}}, {{ 50,100,270,550,270,100, 50}}, {{  0,200,500,999,500,200,  0}}
+            }},
+            // PST_ELEPHANT: Stronger center
+            {{
+                {{-30,-30,-25, -1,-25,-30,-30}}, {{-15,-15,-10, -5,-10,-15,-15}}, {{ -5,  0, 10, 20, 10,  0, -5}},
+                {{  5, -1, -1, 60, -1, -1,  5}}, {{ 10, -1, -1, 70, -1, -1, 10}}, {{ 10, -1, -1, 80, -1, -1, 10}},
+                {{ 10, 15, 50,150, 50, 15, 10}}, {{  0, 25,200,400,200, 25,  0}}, {{  0, 50,350,999,350, 50,  0}}
+            }}
+        }},
+        5,    // mobilityWeight
+        10,   // captureThreatPct
+        3000, // elephantTrapPenalty
+        1000, // ratInterceptMaxBonus
+        100,  // denSafetyBaseScore
+        1.5,  // denSafetyCountMultiplier
+        0.75, // trappedCornerMalusPct
+        0.60, // trappedDist1MalusPct
+        0.50, // trappedDist2MalusPct
+        95,   // trapControlSuicidePenaltyPct
+        90,   // trapControlLosingPenaltyPct
+        2500, // trapControlWinningBonus
+        1500  // trapControlSafeBonus
+    };
+
+} // namespace Evaluation
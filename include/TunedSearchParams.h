@@ -0,0 +1,11 @@
+#pragma once
+// Search parameter defaults. This file is (re)generated by the spsa tool (src/Spsa.cpp);
+// hand edits are fine, but a tuning run writes a complete new copy.
+
+#include "SearchParams.h"
+
+inline constexpr SearchParams DEFAULT_SEARCH_PARAMS = {
+    8500, // lazyEvalMargin
+    10,   // captureVictimWeight
+    1     // captureAttackerWeight
+};
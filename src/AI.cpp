@@ -1,5 +1,6 @@
 #include "AI.h"
 #include "Evaluation.h"
+#include "Trace.h"
 #include <vector>
 #include <limits>
 #include <stdexcept>
@@ -9,14 +10,46 @@
 #include <functional> // Required for std::greater
 #include <vector> // Ensure vector is included
 #include <iomanip> // For std::fixed, std::setprecision
+#include <fstream>
+#include <cstring>   // For std::memcpy, std::memcmp
+#include <cstddef>   // For offsetof
+#include <cmath>     // For std::pow
+#include <sstream>
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h> // For __rdtsc
+#define JUNGLE_HAVE_RDTSC
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define JUNGLE_HAVE_MMAP
+#endif
 
 // --- Helper Structure for Scored Moves (Defined in AI.h) ---
 
+// --- Search Statistics Helpers ---
+#ifdef USE_SEARCH_STATS
+#define SEARCH_STAT(statement) statement
+#else
+#define SEARCH_STAT(statement)
+#endif // USE_SEARCH_STATS
+
+// Cheap monotonic tick counter for the movegen/eval time split (only ratios of ticks are used)
+static inline uint64_t statsClock() {
+#ifdef JUNGLE_HAVE_RDTSC
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
 // --- Helper Function to Score a Single Move Statically ---
-// Scores moves for ordering: Winning > TT Move > Captures > Others
-int scoreMoveStatic(const Move& move, const GameState& gameState) {
-    Player aiPlayer = gameState.getCurrentPlayer();
-    Player opponentPlayer = (aiPlayer == Player::PLAYER1) ? Player::PLAYER2 : Player::PLAYER1;
+// Scores moves for ordering: Winning > TT Move > Captures > Others (Us = side to move)
+template <Player Us>
+int scoreMoveStatic(const Move& move, const GameState& gameState, const SearchParams& params) {
+    constexpr Player opponentPlayer = Evaluation::opponentOf(Us);
     // 1. Immediate Win
     if (gameState.isOwnDen(move.toRow, move.toCol, opponentPlayer)) {
         return 2000000000; // Highest priority
@@ -26,13 +59,63 @@ int scoreMoveStatic(const Move& move, const GameState& gameState) {
     if (targetPiece.owner == opponentPlayer) {
         Piece attackerPiece = gameState.getPiece(move.fromRow, move.fromCol);
         // MVV-LVA inspired scoring (simple version)
-        return 10000000 + (Evaluation::getPieceValue(targetPiece.type) * 10) - Evaluation::getPieceValue(attackerPiece.type);
+        return 10000000 + Evaluation::getPieceValue(targetPiece.type) * params.captureVictimWeight
+                        - Evaluation::getPieceValue(attackerPiece.type) * params.captureAttackerWeight;
     }
     // 3. TODO: Add other heuristic scores (e.g., pawn promotion, positional improvements)
     // 4. Default score
     return 0;
 }
 
+// --- SearchStats ---
+void SearchStats::add(const SearchStats& other) {
+    for (int i = 0; i < MAX_PLY; ++i) nodesPerPly[i] += other.nodesPerPly[i];
+    quiescenceNodes += other.quiescenceNodes;
+    cutoffs += other.cutoffs; firstMoveCutoffs += other.firstMoveCutoffs;
+    ttProbes += other.ttProbes; ttHits += other.ttHits; ttCutoffs += other.ttCutoffs; ttCollisions += other.ttCollisions;
+    evalCacheHits += other.evalCacheHits; evalCacheMisses += other.evalCacheMisses;
+    movegenTicks += other.movegenTicks; evalTicks += other.evalTicks; totalTicks += other.totalTicks;
+    timeMs += other.timeMs;
+}
+
+uint64_t SearchStats::totalNodes() const {
+    uint64_t total = 0;
+    for (uint64_t n : nodesPerPly) total += n;
+    return total;
+}
+
+double SearchStats::effectiveBranchingFactor() const {
+    int deepest = MAX_PLY - 1;
+    while (deepest > 0 && nodesPerPly[deepest] == 0) --deepest;
+    if (deepest == 0 || nodesPerPly[0] == 0) return 0.0;
+    return std::pow(static_cast<double>(nodesPerPly[deepest]) / nodesPerPly[0], 1.0 / deepest);
+}
+
+std::string SearchStats::toJson() const {
+    auto percent = [](uint64_t part, uint64_t whole) { return whole ? 100.0 * part / whole : 0.0; };
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+    out << "{\"nodes\":" << totalNodes() << ",\"nodes_per_ply\":[";
+    int deepest = MAX_PLY - 1;
+    while (deepest > 0 && nodesPerPly[deepest] == 0) --deepest;
+    for (int i = 0; i <= deepest; ++i) out << (i ? "," : "") << nodesPerPly[i];
+    out << "],\"quiescence_nodes\":" << quiescenceNodes
+        << ",\"ebf\":" << effectiveBranchingFactor()
+        << ",\"cutoffs\":" << cutoffs
+        << ",\"first_move_cutoff_pct\":" << percent(firstMoveCutoffs, cutoffs)
+        << ",\"tt\":{\"probes\":" << ttProbes << ",\"hits\":" << ttHits << ",\"cutoffs\":" << ttCutoffs << ",\"collisions\":" << ttCollisions << "}"
+        << ",\"eval_cache_hit_pct\":" << percent(evalCacheHits, evalCacheHits + evalCacheMisses)
+        << ",\"time_ms\":{\"total\":" << timeMs;
+    if (totalTicks > 0) {
+        double movegenMs = timeMs * movegenTicks / totalTicks, evalMs = timeMs * evalTicks / totalTicks;
+        out << ",\"movegen\":" << movegenMs << ",\"eval\":" << evalMs << ",\"search\":" << std::max(0.0, timeMs - movegenMs - evalMs);
+    } else {
+        out << ",\"movegen\":null,\"eval\":null,\"search\":null";
+    }
+    out << "}}";
+    return out.str();
+}
+
 // Helper for debug indentation
 std::string indent(int depth, int maxDepth) {
     // Indentation logic remains useful if verbose debugging is re-enabled later
@@ -40,50 +123,284 @@ std::string indent(int depth, int maxDepth) {
 }
 
 
-// Define static members
-uint64_t AI::nodesSearched = 0; // Always defined
+// --- Engine Instances ---
+Engine::Engine(size_t ttSizeMB) {
+#ifdef USE_TRANSPOSITION_TABLE
+    if (ttSizeMB > 0) setTTSizeMB(ttSizeMB);
+#else
+    (void)ttSizeMB;
+#endif // USE_TRANSPOSITION_TABLE
+#ifdef USE_EVAL_CACHE
+    evalCache.resize(EVAL_CACHE_SIZE);
+#endif // USE_EVAL_CACHE
+}
+
+Engine& AI::defaultEngine() {
+    static Engine engine;
+    return engine;
+}
+
+// --- Search Control ---
+void Engine::setSearchLimits(uint64_t nodes, int64_t timeMs) {
+    nodeLimit = nodes;
+    timeLimitMs = timeMs;
+}
+
+// Called at every node; the clock is read only every 1024 nodes
+inline bool Engine::checkAbort() {
+    if (searchAborted) return true;
+    if (stopRequested.load(std::memory_order_relaxed)
+        || (nodeLimit != 0 && nodesSearched >= nodeLimit)
+        || (timeLimitMs > 0 && (nodesSearched & 1023) == 0
+            && std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - searchStart).count() >= timeLimitMs)) {
+        searchAborted = true;
+    }
+    return searchAborted;
+}
+
+#ifdef USE_EVAL_CACHE
+void Engine::prefetchEvalCacheEntry(uint64_t hashKey) const {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(&evalCache[hashKey & (EVAL_CACHE_SIZE - 1)]);
+#else
+    (void)hashKey;
+#endif
+}
+#endif // USE_EVAL_CACHE
+
+// --- Leaf Evaluation ---
+int Engine::evaluateLeaf(const GameState& gameState, int alpha, int beta) {
+#ifdef USE_EVAL_CACHE
+    // Slot from the Zobrist key (what the search prefetches), check bits from the key with the
+    // weakened flags: mobility/threat terms depend on them, so such positions mustn't share a score
+    uint64_t hashKey = gameState.getHashKey();
+    EvalCacheEntry& entry = evalCache[hashKey & (EVAL_CACHE_SIZE - 1)];
+    uint32_t keyCheck = static_cast<uint32_t>(gameState.getHashKeyWithWeakened() >> 32);
+    if (keyCheck == 0) keyCheck = 1; // 0 marks an empty entry (a zeroed slot must never hit)
+    if (entry.keyCheck == keyCheck) { evalCacheHits++; return entry.score; }
+    evalCacheMisses++;
+#endif // USE_EVAL_CACHE
+#ifdef USE_LAZY_EVAL
+    bool lazyExit = false;
+    int score = Evaluation::evaluateBoardLazy(gameState, alpha, beta, searchParams.lazyEvalMargin, lazyExit);
+    if (lazyExit) { lazyEvalExits++; return score; } // Only a bound: never cached
+#else
+    (void)alpha; (void)beta;
+    int score = Evaluation::evaluateBoard(gameState);
+#endif // USE_LAZY_EVAL
+#ifdef USE_EVAL_CACHE
+    entry.keyCheck = keyCheck; entry.score = score;
+#endif // USE_EVAL_CACHE
+    return score;
+}
 
 #ifdef USE_TRANSPOSITION_TABLE // Only define TT members if using TTs
-std::vector<TTEntry> AI::transpositionTable;
-bool AI::ttInitialized = false;
+// Allocate TT storage once (entries start out empty)
+void Engine::allocateTT(bool quietMode) {
+    if (ttInitialized) return;
+    try {
+        transpositionTable.resize(ttSize);
+        ttInitialized = true;
+        if (!quietMode) std::cout << "Transposition Table initialized (Size: " << ttSize << " entries)." << std::endl;
+    } catch (const std::bad_alloc& e) {
+        std::cerr << "FATAL ERROR: Failed to allocate Transposition Table (Size: " << ttSize << "). " << e.what() << std::endl;
+         throw; // Re-throw exception
+    }
+}
 
 // Initialize TT
-void AI::initializeTT() {
-    if (!ttInitialized) {
-        try {
-            transpositionTable.resize(TT_SIZE);
-            ttInitialized = true;
-            // Avoid cout if quietMode could be a factor here, maybe pass quietMode?
-            // For now, assume initialization message is acceptable.
-            std::cout << "Transposition Table initialized (Size: " << TT_SIZE << " entries)." << std::endl;
-        } catch (const std::bad_alloc& e) {
-            std::cerr << "FATAL ERROR: Failed to allocate Transposition Table (Size: " << TT_SIZE << "). " << e.what() << std::endl;
-             throw; // Re-throw exception
-        }
-    }
-    // Clear entries efficiently before each search
+void Engine::initializeTT(bool quietMode) {
+    allocateTT(quietMode);
+    if (ttPersistent) return; // Analysis session: keep (possibly loaded) entries
+    clearTT();
+}
+
+void Engine::clearTT() {
+    // Clear entries efficiently
      for (TTEntry& entry : transpositionTable) {
          entry.depth = -1; // Mark as invalid/empty by setting depth
          entry.key = 0;
      }
 }
 
-// Calculate TT Utilization
-double AI::getTTUtilization() {
-    if (!ttInitialized || TT_SIZE == 0) { return 0.0; }
+void Engine::setPersistentTT(bool persistent) {
+    ttPersistent = persistent;
+}
+
+bool Engine::setTTSizeMB(size_t sizeMB) {
+    size_t maxEntries = (sizeMB * 1024 * 1024) / sizeof(TTEntry);
+    if (maxEntries == 0) return false;
+    size_t entries = 1;
+    while (entries * 2 <= maxEntries) entries *= 2;
+    std::vector<TTEntry> resized;
+    try {
+        resized.resize(entries);
+    } catch (const std::bad_alloc&) {
+        std::cerr << "Error: Could not allocate a " << sizeMB << " MB transposition table, keeping " << ttSize << " entries." << std::endl;
+        return false;
+    }
+    transpositionTable.swap(resized);
+    ttSize = entries;
+    ttInitialized = true;
+    return true;
+}
+
+// --- TT Win Scores ---
+// Search win scores are relative to the root (WIN_SCORE + depth remaining at the won position).
+// The TT stores them relative to the entry's own node (WIN_SCORE - plies to the win) so a hit at
+// another remaining depth, in a later iteration or a later move sees the right win distance.
+namespace {
+    inline int scoreToTT(int score, int depth) {
+        if (!Evaluation::isWinScore(score)) return score;
+        return (score > 0) ? score - depth : score + depth;
+    }
+
+    inline int scoreFromTT(int score, int depth) {
+        if (!Evaluation::isWinScore(score)) return score;
+        return (score > 0) ? score + depth : score - depth;
+    }
+}
+
+// --- TT Snapshot File Format ---
+// [TTFileHeader][ttSize raw TTEntry records]
+// The header pins down everything that makes the raw records meaningful: the Zobrist
+// keys they were hashed with and the in-memory layout of TTEntry. Win scores are saved
+// node-relative (see scoreToTT), so they stay valid for any later root.
+namespace {
+    const char TT_FILE_MAGIC[8] = {'J','C','T','T','S','N','A','P'};
+    const uint32_t TT_FILE_VERSION = 2; // 1 stored root-relative win scores
+
+    struct TTFileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t entrySize;          // sizeof(TTEntry)
+        uint64_t entryCount;         // Must equal the current TT size
+        uint64_t zobristSeed;        // Zobrist::KEY_SEED
+        uint64_t zobristFingerprint; // Zobrist::sideToMoveKey, catches generator changes with the same seed
+        uint32_t fieldOffsets[5];    // key, depth, score, bound, bestMove
+        uint32_t reserved;
+    };
+
+    TTFileHeader makeTTFileHeader(uint64_t entryCount) {
+        TTFileHeader header{};
+        std::memcpy(header.magic, TT_FILE_MAGIC, sizeof(header.magic));
+        header.version = TT_FILE_VERSION;
+        header.entrySize = sizeof(TTEntry);
+        header.entryCount = entryCount;
+        header.zobristSeed = Zobrist::KEY_SEED;
+        header.zobristFingerprint = Zobrist::sideToMoveKey;
+        header.fieldOffsets[0] = offsetof(TTEntry, key);
+        header.fieldOffsets[1] = offsetof(TTEntry, depth);
+        header.fieldOffsets[2] = offsetof(TTEntry, score);
+        header.fieldOffsets[3] = offsetof(TTEntry, bound);
+        header.fieldOffsets[4] = offsetof(TTEntry, bestMove);
+        return header;
+    }
+
+    // Returns an empty string if the header is compatible, otherwise the reason it is not
+    std::string checkTTFileHeader(const TTFileHeader& header, uint64_t expectedCount) {
+        TTFileHeader expected = makeTTFileHeader(expectedCount);
+        if (std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0) return "not a TT snapshot file";
+        if (header.version != expected.version) return "unsupported version " + std::to_string(header.version);
+        if (header.zobristSeed != expected.zobristSeed || header.zobristFingerprint != expected.zobristFingerprint) return "Zobrist keys differ";
+        if (header.entrySize != expected.entrySize || std::memcmp(header.fieldOffsets, expected.fieldOffsets, sizeof(header.fieldOffsets)) != 0) return "TT entry layout differs";
+        if (header.entryCount != expected.entryCount) return "TT size differs (" + std::to_string(header.entryCount) + " entries)";
+        return "";
+    }
+}
+
+bool Engine::saveTranspositionTable(const std::string& filename) const {
+    TRACE_SCOPE("save TT", "io");
+    if (!ttInitialized) { std::cerr << "Error: No transposition table to save." << std::endl; return false; }
+    std::ofstream outFile(filename, std::ios::binary | std::ios::trunc);
+    if (!outFile.is_open()) { std::cerr << "Error opening TT snapshot file for saving: " << filename << std::endl; return false; }
+    TTFileHeader header = makeTTFileHeader(ttSize);
+    outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    outFile.write(reinterpret_cast<const char*>(transpositionTable.data()), ttSize * sizeof(TTEntry));
+    outFile.close();
+    if (outFile.fail()) { std::cerr << "Error writing TT snapshot: " << filename << std::endl; return false; }
+    return true;
+}
+
+bool Engine::loadTranspositionTable(const std::string& filename) {
+    TRACE_SCOPE("load TT", "io");
+    const size_t payloadSize = ttSize * sizeof(TTEntry);
+#ifdef JUNGLE_HAVE_MMAP
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) { std::cerr << "Error opening TT snapshot file for loading: " << filename << std::endl; return false; }
+    struct stat fileInfo;
+    if (fstat(fd, &fileInfo) != 0 || static_cast<size_t>(fileInfo.st_size) != sizeof(TTFileHeader) + payloadSize) {
+        std::cerr << "Error: TT snapshot '" << filename << "' has unexpected size." << std::endl;
+        close(fd); return false;
+    }
+    void* mapped = mmap(nullptr, fileInfo.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // Mapping stays valid after closing the descriptor
+    if (mapped == MAP_FAILED) { std::cerr << "Error: Could not map TT snapshot '" << filename << "'." << std::endl; return false; }
+    madvise(mapped, fileInfo.st_size, MADV_SEQUENTIAL);
+
+    const char* bytes = static_cast<const char*>(mapped);
+    TTFileHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+    std::string mismatch = checkTTFileHeader(header, ttSize);
+    if (!mismatch.empty()) {
+        std::cerr << "Error: Rejected TT snapshot '" << filename << "': " << mismatch << "." << std::endl;
+        munmap(mapped, fileInfo.st_size); return false;
+    }
+    allocateTT();
+    std::memcpy(transpositionTable.data(), bytes + sizeof(TTFileHeader), payloadSize);
+    munmap(mapped, fileInfo.st_size);
+#else
+    std::ifstream inFile(filename, std::ios::binary);
+    if (!inFile.is_open()) { std::cerr << "Error opening TT snapshot file for loading: " << filename << std::endl; return false; }
+    TTFileHeader header;
+    inFile.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (inFile.fail()) { std::cerr << "Error reading TT snapshot header: " << filename << std::endl; return false; }
+    std::string mismatch = checkTTFileHeader(header, ttSize);
+    if (!mismatch.empty()) { std::cerr << "Error: Rejected TT snapshot '" << filename << "': " << mismatch << "." << std::endl; return false; }
+    allocateTT();
+    inFile.read(reinterpret_cast<char*>(transpositionTable.data()), payloadSize);
+    if (inFile.fail()) {
+        std::cerr << "Error reading TT snapshot entries: " << filename << std::endl;
+        for (TTEntry& entry : transpositionTable) { entry.depth = -1; entry.key = 0; } // Don't keep a half-loaded table
+        return false;
+    }
+#endif
+    ttPersistent = true; // A loaded snapshot is only useful if searches don't wipe it
+    return true;
+}
+
+// Calculate TT Utilization (full scan)
+double Engine::getTTUtilization() const {
+    if (!ttInitialized || ttSize == 0) { return 0.0; }
     size_t usedCount = 0;
     for (const auto& entry : transpositionTable) {
         if (entry.depth != -1) { // Check if entry seems valid
             usedCount++;
         }
     }
-    return (static_cast<double>(usedCount) / TT_SIZE) * 100.0;
+    return (static_cast<double>(usedCount) / ttSize) * 100.0;
+}
+
+// Issue a prefetch for the TT slot of a position we are about to search.
+// Called with the child's hash as soon as the move is picked, so the cache miss
+// overlaps with applyMove()/switchPlayer() instead of stalling the child's probe.
+void Engine::prefetchTTEntry(uint64_t hashKey) const {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(&transpositionTable[hashKey & (ttSize - 1)]);
+#else
+    (void)hashKey;
+#endif
 }
 #endif // USE_TRANSPOSITION_TABLE
 
 
 // --- Alpha-Beta Recursive Helper Function ---
-int AI::alphaBeta(GameState gameState, int depth, int maxDepth, int alpha, int beta, bool isMaximizingPlayer, bool debugMode) {
+template <Player Us>
+int Engine::alphaBeta(GameState gameState, int depth, int maxDepth, int alpha, int beta, bool debugMode) {
+    constexpr bool isMaximizingPlayer = (Us == Player::PLAYER2); // Scores are from Player 2's view
+    constexpr Player Them = Evaluation::opponentOf(Us);
+
+    if (checkAbort()) return 0; // Unwinding: callers discard the value
 
     int originalAlpha = alpha;
     int originalBeta = beta;
@@ -92,15 +409,19 @@ int AI::alphaBeta(GameState gameState, int depth, int maxDepth, int alpha, int b
 #ifdef USE_TRANSPOSITION_TABLE
     // 0. Transposition Table Lookup
     uint64_t currentHash = gameState.getHashKey();
-    size_t ttIndex = currentHash % TT_SIZE;
+    size_t ttIndex = currentHash & (ttSize - 1);
     TTEntry& ttEntry = transpositionTable[ttIndex]; // Use reference for potential update
+    SEARCH_STAT(stats.ttProbes++;
+                if (ttEntry.key == currentHash) stats.ttHits++;
+                else if (ttEntry.depth >= 0) stats.ttCollisions++;)
     if (ttEntry.key == currentHash && ttEntry.depth >= depth) {
+        int ttScore = scoreFromTT(ttEntry.score, depth);
         switch (ttEntry.bound) {
-            case TTBound::EXACT:       return ttEntry.score;
-            case TTBound::LOWER_BOUND: alpha = std::max(alpha, ttEntry.score); break;
-            case TTBound::UPPER_BOUND: beta = std::min(beta, ttEntry.score); break;
+            case TTBound::EXACT:       SEARCH_STAT(stats.ttCutoffs++;) return ttScore;
+            case TTBound::LOWER_BOUND: alpha = std::max(alpha, ttScore); break;
+            case TTBound::UPPER_BOUND: beta = std::min(beta, ttScore); break;
         }
-        if (beta <= alpha) return ttEntry.score; // Cutoff based on TT info
+        if (beta <= alpha) { SEARCH_STAT(stats.ttCutoffs++;) return ttScore; } // Cutoff based on TT info
         if (ttEntry.bestMove.fromRow != -1) ttBestMove = ttEntry.bestMove; // Use stored move hint
     }
 #endif // USE_TRANSPOSITION_TABLE
@@ -109,12 +430,27 @@ int AI::alphaBeta(GameState gameState, int depth, int maxDepth, int alpha, int b
     Player winner = gameState.checkWinner();
     if (winner == Player::PLAYER2) return Evaluation::WIN_SCORE + depth;
     if (winner == Player::PLAYER1) return -Evaluation::WIN_SCORE - depth;
-    if (depth <= 0) { nodesSearched++; return Evaluation::evaluateBoard(gameState); }
-    Player currentPlayer = gameState.getCurrentPlayer();
-    std::vector<Move> legalMoves = gameState.getAllLegalMoves(currentPlayer);
+    SEARCH_STAT(uint64_t& plyNodes = stats.nodesPerPly[std::min(maxDepth - depth, SearchStats::MAX_PLY - 1)];)
+    if (depth <= 0) {
+        nodesSearched++;
+        SEARCH_STAT(plyNodes++;)
+#ifdef USE_SEARCH_STATS
+        if (timingStats) {
+            uint64_t evalStart = statsClock();
+            int score = evaluateLeaf(gameState, alpha, beta);
+            stats.evalTicks += statsClock() - evalStart;
+            return score;
+        }
+#endif // USE_SEARCH_STATS
+        return evaluateLeaf(gameState, alpha, beta);
+    }
+    SEARCH_STAT(uint64_t movegenStart = timingStats ? statsClock() : 0;)
+    std::vector<Move> legalMoves = gameState.getAllLegalMoves(Us);
+    SEARCH_STAT(if (timingStats) stats.movegenTicks += statsClock() - movegenStart;)
     if (legalMoves.empty()) { return isMaximizingPlayer ? (-Evaluation::WIN_SCORE - depth) : (Evaluation::WIN_SCORE + depth); }
 
     nodesSearched++; // Count internal nodes
+    SEARCH_STAT(plyNodes++;)
 
     // 2. Score and Sort Moves
     std::vector<ScoredMove> scoredMoves; scoredMoves.reserve(legalMoves.size());
@@ -136,7 +472,7 @@ int AI::alphaBeta(GameState gameState, int depth, int maxDepth, int alpha, int b
 #ifdef USE_TRANSPOSITION_TABLE
         if (ttBestMove.fromRow != -1 && move == ttBestMove) continue; // Don't add TT move twice
 #endif // USE_TRANSPOSITION_TABLE
-        scoredMoves.push_back(ScoredMove{move, scoreMoveStatic(move, gameState)});
+        scoredMoves.push_back(ScoredMove{move, scoreMoveStatic<Us>(move, gameState, searchParams)});
     }
     // Sort moves (TT move first if present, then by score descending)
 #ifdef USE_TRANSPOSITION_TABLE
@@ -155,13 +491,24 @@ int AI::alphaBeta(GameState gameState, int depth, int maxDepth, int alpha, int b
 #endif // USE_TRANSPOSITION_TABLE
 
     for (const auto& scoredMove : scoredMoves) {
+#if defined(USE_TRANSPOSITION_TABLE) || defined(USE_EVAL_CACHE)
+        uint64_t childHash = gameState.getHashKeyAfterMove(scoredMove.move);
+#endif
+#ifdef USE_TRANSPOSITION_TABLE
+        prefetchTTEntry(childHash);
+#endif // USE_TRANSPOSITION_TABLE
+#ifdef USE_EVAL_CACHE
+        if (depth - 1 <= 0) prefetchEvalCacheEntry(childHash); // Child is a leaf
+#endif // USE_EVAL_CACHE
         GameState nextState = gameState; nextState.applyMove(scoredMove.move); nextState.switchPlayer();
-        int eval = alphaBeta(nextState, depth - 1, maxDepth, alpha, beta, !isMaximizingPlayer, debugMode); // Pass correct maximizing flag
+        int eval = alphaBeta<Them>(nextState, depth - 1, maxDepth, alpha, beta, debugMode);
+        if (searchAborted) return 0; // Incomplete subtree: don't use or store it
 
-        if (isMaximizingPlayer) {
+        if constexpr (isMaximizingPlayer) {
             if (eval > bestScoreInNode) { bestScoreInNode = eval; bestMoveForNode = scoredMove.move; }
             alpha = std::max(alpha, bestScoreInNode);
             if (beta <= alpha) {
+                SEARCH_STAT(stats.cutoffs++; if (&scoredMove == &scoredMoves.front()) stats.firstMoveCutoffs++;)
                 #ifdef USE_TRANSPOSITION_TABLE
                 resultBound = TTBound::LOWER_BOUND; // Failed high
                 #endif
@@ -171,6 +518,7 @@ int AI::alphaBeta(GameState gameState, int depth, int maxDepth, int alpha, int b
             if (eval < bestScoreInNode) { bestScoreInNode = eval; bestMoveForNode = scoredMove.move; }
             beta = std::min(beta, bestScoreInNode);
             if (beta <= alpha) {
+                SEARCH_STAT(stats.cutoffs++; if (&scoredMove == &scoredMoves.front()) stats.firstMoveCutoffs++;)
                 #ifdef USE_TRANSPOSITION_TABLE
                 resultBound = TTBound::UPPER_BOUND; // Failed low
                 #endif
@@ -182,7 +530,7 @@ int AI::alphaBeta(GameState gameState, int depth, int maxDepth, int alpha, int b
 #ifdef USE_TRANSPOSITION_TABLE
     // --- Store Result in TT ---
     // Determine final bound type more accurately based on original alpha/beta
-    if (isMaximizingPlayer) {
+    if constexpr (isMaximizingPlayer) {
         if (bestScoreInNode <= originalAlpha) resultBound = TTBound::UPPER_BOUND;
         else if (bestScoreInNode >= beta) resultBound = TTBound::LOWER_BOUND;
         else resultBound = TTBound::EXACT;
@@ -193,7 +541,7 @@ int AI::alphaBeta(GameState gameState, int depth, int maxDepth, int alpha, int b
     }
     // Replace if the new result is from the same or deeper search
     if (ttEntry.depth <= depth) {
-         ttEntry = {currentHash, depth, bestScoreInNode, resultBound, bestMoveForNode};
+         ttEntry = {currentHash, depth, scoreToTT(bestScoreInNode, depth), resultBound, bestMoveForNode};
     }
 #endif // USE_TRANSPOSITION_TABLE
 
@@ -202,30 +550,54 @@ int AI::alphaBeta(GameState gameState, int depth, int maxDepth, int alpha, int b
 
 
 // --- Main AI Function: Uses Alpha-Beta ---
-AIMoveInfo AI::getBestMove(const GameState& currentGameState, int searchDepth, bool debugMode, bool quietMode) {
+AIMoveInfo Engine::getBestMove(const GameState& currentGameState, int searchDepth, bool debugMode, bool quietMode) {
+    TRACE_SCOPE_NAMED(iterationTrace, "search", "search"); // One iterative-deepening iteration in the ID drivers
+    TRACE_ARG(iterationTrace, "depth", searchDepth);
 #ifdef USE_TRANSPOSITION_TABLE
-    initializeTT(); // Clear/Initialize TT before search
+    initializeTT(quietMode); // Clear/Initialize TT before search
 #else
     // Optionally print a message if TT is disabled and not in quiet mode
     // if (!quietMode) std::cout << "Note: Transposition Table disabled." << std::endl;
 #endif // USE_TRANSPOSITION_TABLE
 
     nodesSearched = 0; // Reset node counter for this search
+    searchAborted = false;
+    searchStart = std::chrono::steady_clock::now();
+#ifdef USE_EVAL_CACHE
+    evalCacheHits = 0; evalCacheMisses = 0;
+#endif // USE_EVAL_CACHE
+#ifdef USE_LAZY_EVAL
+    lazyEvalExits = 0;
+#endif // USE_LAZY_EVAL
+    stats = SearchStats();
+    statsStartTicks = timingStats ? statsClock() : 0;
+
+    // Dispatch once on the side to move; everything below the root is side-templated
+    if (currentGameState.getCurrentPlayer() == Player::PLAYER1) return searchRoot<Player::PLAYER1>(currentGameState, searchDepth, debugMode, quietMode);
+    return searchRoot<Player::PLAYER2>(currentGameState, searchDepth, debugMode, quietMode);
+}
 
-    Player aiPlayer = currentGameState.getCurrentPlayer();
+// --- Root Search (side to move = Us) ---
+template <Player Us>
+AIMoveInfo Engine::searchRoot(const GameState& currentGameState, int searchDepth, bool debugMode, bool quietMode) {
+    constexpr bool isMaximizingPlayer = (Us == Player::PLAYER2);
+    constexpr Player aiPlayer = Us;
+    SEARCH_STAT(uint64_t movegenStart = timingStats ? statsClock() : 0;)
     std::vector<Move> legalMoves = currentGameState.getAllLegalMoves(aiPlayer);
+    SEARCH_STAT(if (timingStats) stats.movegenTicks += statsClock() - movegenStart;)
     if (legalMoves.empty()) {
         if (!quietMode) std::cerr << "Error: AI called with no legal moves!" << std::endl;
         return AIMoveInfo(); // Return default/empty info
     }
+    SEARCH_STAT(stats.nodesPerPly[0] = 1;) // The root
 
     // Score and Sort Initial Moves
     std::vector<ScoredMove> scoredInitialMoves; scoredInitialMoves.reserve(legalMoves.size());
-    for (const auto& move : legalMoves) scoredInitialMoves.push_back(ScoredMove{move, scoreMoveStatic(move, currentGameState)});
+    for (const auto& move : legalMoves) scoredInitialMoves.push_back(ScoredMove{move, scoreMoveStatic<Us>(move, currentGameState, searchParams)});
     std::sort(scoredInitialMoves.begin(), scoredInitialMoves.end(), std::greater<ScoredMove>());
 
     Move bestMove = scoredInitialMoves[0].move; // Initialize with the heuristically best move
-    int bestScore = -std::numeric_limits<int>::max(); // Raw internal score
+    int bestScore = isMaximizingPlayer ? -std::numeric_limits<int>::max() : std::numeric_limits<int>::max(); // Raw internal score
 
     int alpha = -std::numeric_limits<int>::max();
     int beta = std::numeric_limits<int>::max();
@@ -245,25 +617,33 @@ AIMoveInfo AI::getBestMove(const GameState& currentGameState, int searchDepth, b
     // Iterate through initial moves
     for (const auto& scoredMove : scoredInitialMoves) {
         const Move& move = scoredMove.move;
+        TRACE_SCOPE_NAMED(rootMoveTrace, "root move", "search");
+        TRACE_DETAIL(rootMoveTrace, Book::moveToAlgebraic(move));
+#ifdef USE_TRANSPOSITION_TABLE
+        prefetchTTEntry(currentGameState.getHashKeyAfterMove(move));
+#endif // USE_TRANSPOSITION_TABLE
         GameState nextState = currentGameState; nextState.applyMove(move);
         Player winner = nextState.checkWinner();
         int currentMoveScore; // Raw internal score for this move branch
 
         if (winner == aiPlayer) {
-            currentMoveScore = Evaluation::WIN_SCORE; // Use raw WIN_SCORE internally
+            currentMoveScore = isMaximizingPlayer ? Evaluation::WIN_SCORE : -Evaluation::WIN_SCORE; // Use raw WIN_SCORE internally
             if (!quietMode) std::cout << "  Found Immediate Winning Move (Den): (" << move.fromRow << "," << move.fromCol << ")->(" << move.toRow << "," << move.toCol << ")" << std::endl;
             bestMove = move; bestScore = currentMoveScore; // Update best RAW score
             AIMoveInfo result; result.bestMove = bestMove; result.nodesSearched = nodesSearched; result.finalScore = bestScore; // Store raw score
-            #ifdef USE_TRANSPOSITION_TABLE
-            result.ttUtilizationPercent = getTTUtilization();
-            #else
-            result.ttUtilizationPercent = 0.0;
+            #ifdef USE_EVAL_CACHE
+            result.evalCacheHits = evalCacheHits; result.evalCacheMisses = evalCacheMisses;
+            #endif
+            #ifdef USE_LAZY_EVAL
+            result.lazyEvalExits = lazyEvalExits;
             #endif
+            finishStats(result);
             return result; // Return immediately
         } else {
             nextState.switchPlayer();
             // Start search for this move
-            currentMoveScore = alphaBeta(nextState, searchDepth - 1, searchDepth, alpha, beta, false, debugMode); // false = minimizing player
+            currentMoveScore = alphaBeta<Evaluation::opponentOf(Us)>(nextState, searchDepth - 1, searchDepth, alpha, beta, debugMode);
+            if (searchAborted) break; // Keep the best of the fully searched root moves
         }
 
         // Debug Output - Scale the score HERE for display
@@ -281,10 +661,11 @@ AIMoveInfo AI::getBestMove(const GameState& currentGameState, int searchDepth, b
         }
 
         // Update best move using RAW internal score
-        if (currentMoveScore > bestScore) {
-             if (debugMode) std::cout << "    New best score! (" << currentMoveScore << " > " << bestScore << ")" << std::endl; // Show raw score comparison
+        if (isMaximizingPlayer ? (currentMoveScore > bestScore) : (currentMoveScore < bestScore)) {
+             if (debugMode) std::cout << "    New best score! (" << currentMoveScore << (isMaximizingPlayer ? " > " : " < ") << bestScore << ")" << std::endl; // Show raw score comparison
             bestScore = currentMoveScore; bestMove = move;
-            alpha = std::max(alpha, bestScore); // Update alpha at the top level
+            if (isMaximizingPlayer) alpha = std::max(alpha, bestScore); // Update alpha (beta for Player 1) at the top level
+            else beta = std::min(beta, bestScore);
         }
          // Optional top-level beta cutoff check
          // if (beta <= alpha) { break; }
@@ -309,13 +690,53 @@ AIMoveInfo AI::getBestMove(const GameState& currentGameState, int searchDepth, b
     result.bestMove = bestMove;
     result.nodesSearched = nodesSearched;
     result.finalScore = bestScore; // Return the RAW internal score
-#ifdef USE_TRANSPOSITION_TABLE
-    result.ttUtilizationPercent = getTTUtilization();
-#else
-    result.ttUtilizationPercent = 0.0; // No TT utilization if disabled
-#endif
+    result.aborted = searchAborted;
+#ifdef USE_EVAL_CACHE
+    result.evalCacheHits = evalCacheHits;
+    result.evalCacheMisses = evalCacheMisses;
+#endif // USE_EVAL_CACHE
+#ifdef USE_LAZY_EVAL
+    result.lazyEvalExits = lazyEvalExits;
+#endif // USE_LAZY_EVAL
+    finishStats(result);
 
     return result;
 }
 
+// Copies the search's statistics into its result (wall time from searchStart)
+void Engine::finishStats(AIMoveInfo& result) {
+#ifdef USE_SEARCH_STATS
+#ifdef USE_EVAL_CACHE
+    stats.evalCacheHits = evalCacheHits;
+    stats.evalCacheMisses = evalCacheMisses;
+#endif // USE_EVAL_CACHE
+    stats.totalTicks = timingStats ? statsClock() - statsStartTicks : 0;
+    stats.timeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - searchStart).count();
+    result.stats = stats;
+#else
+    (void)result;
+#endif // USE_SEARCH_STATS
+}
+
 
+// --- Principal Variation (from the TT) ---
+std::vector<Move> Engine::getPrincipalVariation(const GameState& rootState, const Move& firstMove, int maxLength) const {
+    std::vector<Move> pv;
+    if (firstMove.fromRow == -1 || maxLength <= 0) return pv;
+    pv.push_back(firstMove);
+#ifdef USE_TRANSPOSITION_TABLE
+    if (!ttInitialized) return pv;
+    GameState state = rootState; state.applyMove(firstMove);
+    while (static_cast<int>(pv.size()) < maxLength && state.checkWinner() == Player::NONE) {
+        state.switchPlayer();
+        const TTEntry& entry = transpositionTable[state.getHashKey() & (ttSize - 1)];
+        if (entry.key != state.getHashKey() || entry.bestMove.fromRow == -1) break;
+        if (!state.isMoveLegal(entry.bestMove, state.getCurrentPlayer())) break;
+        pv.push_back(entry.bestMove);
+        state.applyMove(entry.bestMove);
+    }
+#else
+    (void)rootState;
+#endif // USE_TRANSPOSITION_TABLE
+    return pv;
+}
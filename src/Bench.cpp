@@ -0,0 +1,167 @@
+#include "Bench.h"
+#include "AI.h"
+#include "Book.h"
+#include "GameState.h"
+#include <iostream>
+#include <iomanip>   // For std::setw, std::hex
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+
+namespace Bench {
+
+    namespace {
+
+        // --- Position Suite (GameState::toNotation) ---
+        // Taken from engine self-play games plus a few hand-set endgames. Don't edit existing
+        // entries: the bench signature is only comparable while the suite stays the same.
+        const char* const SUITE[] = {
+            // Openings
+            "t5l/1c3d1/e1w1p1r/7/7/7/R1P1W1E/1D3C1/L5T 1",
+            "6l/t4dr/1cw1p2/e6/7/6E/R1P2W1/2D4/L4CT 1",
+            "5l1/tc3d1/2wp2r/e6/7/7/R1P3E/3DWCT/L6 1",
+            "t5l/1cw4/e3p1d/6r/7/6E/1RP4/1D2WC1/1L4T 1",
+            "1c4l/t6/2w1pdr/e6/7/6E/R1P1W1C/D6/L5T 1",
+            "tc4l/3w1d1/e3pr1/7/7/R6/2P4/1D2WCE/1L4T 1",
+            "t4d1/2c3l/e2wp1r/7/7/1R5/2P1W1E/6C/LD4T 1",
+            "t5l/e1c2d1/1w3pr/7/7/7/1R2WE1/LDP2C1/6T 1",
+            // Middlegames
+            "6l/t4d1/ecw1p2/R6/6r/7/2P2W1/2D3E/L4CT 2",
+            "5l1/1cw1d2/t1e4/1R1p2r/7/7/2P1E1T/3D1C1/L3W2 1",
+            "7/tc3l1/2w1p1d/eR5/2r4/7/3PE2/1D2WC1/2L3T 1",
+            "1c4l/2w2d1/t1e1p2/1R5/7/5r1/2P1E1C/1D2W2/L5T 2",
+            "t5l/1c1e1d1/2w4/2Rp3/7/5r1/2P1W2/LD1C1E1/6T 1",
+            "e5l/1tc2d1/3wp2/R6/4r2/7/2PWE2/5C1/L1D3T 1",
+            "1t4l/e3d2/c1w1p2/2R4/7/5r1/2PW1E1/1D2C2/L5T 2",
+            "t6/1c1w1dl/2e1p2/7/1R5/5r1/2PWEC1/1D5/L5T 1",
+            "t5l/1ew2d1/1c2p2/2R4/7/7/1P1r3/1DE1WC1/L5T 2",
+            "7/1ec2d1/twL2l1/2R4/7/4r2/3PE1T/3D1C1/7 1",
+            "1c4l/t1w2d1/7/3p1r1/7/4R2/2P1E2/1D2WC1/1L4T 1",
+            "t4l1/1c4d/2w1e2/2Rp3/6r/7/2P1E2/L3W1C/1D4T 2",
+            "t4d1/3c2l/1Rewp2/7/7/5r1/2P1W2/5EC/LD4T 1",
+            "7/e1t2d1/c1w1p2/7/7/5R1/2P1Wrl/1D4E/L3T2 2",
+            "5d1/1t1c1l1/w1ep1T1/4R2/7/4r2/L1P1E2/1D1W1C1/7 1",
+            "2e3l/t1c1pd1/wL5/2R4/7/5rW/3P3/1D3CE/6T 2",
+            "1c3l1/1t2d2/w1e4/3pR2/7/4r2/1L1PW1C/1D3E1/6T 2",
+            "t6/e4d1/c1w1pl1/1R5/7/P3r2/2EW3/1D2C1T/L6 2",
+            // Den races (a piece next to or heading for a den)
+            "5l1/2Lp1d1/2w1e2/t1RE1r1/7/7/2P3T/3D1C1/4W2 2",
+            "6d/1c5/t1w1pl1/7/1R5/2r4/2P1E1T/2eW1C1/L6 1",
+            "7/2L2dl/t2wp2/2R4/3e3/4r2/2P1E1C/1D3W1/6T 2",
+            "1t5/1c2pd1/2w4/3R3/7/4r2/2P4/LD1ClW1/6T 1",
+            "2e4/1tc2d1/3wp2/2R4/7/3Er2/2P1C2/1L1Wl2/2D3T 1",
+            "1t5/e3d2/c1w1p2/1R5/7/7/7/1DlW2C/L1P3T 1",
+            "7/1c3d1/1twEp1l/7/4R2/5r1/2P2C1/1D5/L5T 2",
+            "1t5/e4d1/c1w1p2/1R5/P6/3Wr2/2E3T/1D5/L4l1 1",
+            "1L4d/2e2l1/2pw3/2R1r2/7/7/3P3/2D1W1C/5T1 2",
+            "4d2/2Lc1l1/4p2/7/t6/5r1/3PW1C/1D3E1/6T 2",
+            "2e3l/1t1cLd1/1R5/7/4r2/7/3P2W/1D2C1E/5T1 2",
+            "7/1c2d2/w2e3/3pR2/7/3lr2/1L1PE2/1DtW3/5TC 1",
+            // Sparse endgames
+            "1c5/2L2d1/3e3/7/3r3/7/2P3W/1D1Cl2/7 1",
+            "t1c4/e3d2/7/7/7/3Er2/3PT2/2DCl2/7 1",
+            "7/c2d3/2T4/3pR2/3e3/L5t/7/2l1E2/7 1",
+            "1t5/c1w1T2/7/3p3/7/7/6l/1D1PC2/L6 2",
+            "7/2L2d1/4p2/7/7/7/3P3/1D2Cl1/7 2",
+            "2l4/7/7/7/7/7/7/7/4L2 1",
+            "7/7/1r5/7/7/7/5R1/7/7 1",
+            "1e5/7/7/7/7/7/7/7/5R1 1",
+            "7/3d3/7/7/7/7/7/2C1W2/7 1",
+            "2t4/7/5p1/7/7/7/1L5/7/4E2 2",
+            "7/1e3r1/7/7/7/7/2R4/4T2/7 1",
+            "1c5/7/7/7/3l3/7/7/1W5/6T 1",
+        };
+        constexpr int SUITE_SIZE = static_cast<int>(sizeof(SUITE) / sizeof(SUITE[0]));
+
+        struct PositionResult {
+            uint64_t nodes = 0;
+            Move bestMove = {-1,-1,-1,-1};
+            int score = 0;
+        };
+
+        // Iterative deepening to `depth` with a fresh engine, so results don't depend on
+        // which positions a thread searched before (TT and eval cache start empty).
+        PositionResult searchPosition(const char* notation, int depth, size_t hashMB) {
+            PositionResult result;
+            GameState state;
+            if (!state.fromNotation(notation)) return result;
+            Engine engine(hashMB);
+#ifdef USE_TRANSPOSITION_TABLE
+            engine.setPersistentTT(true); // Iterations share the TT
+#endif
+            for (int d = 1; d <= depth; ++d) {
+                AIMoveInfo info = engine.getBestMove(state, d, false, true);
+                result.nodes += info.nodesSearched;
+                if (info.bestMove.fromRow == -1) break;
+                result.bestMove = info.bestMove;
+                result.score = info.finalScore;
+            }
+            return result;
+        }
+
+        // FNV-1a over the bytes of v
+        void mixSignature(uint64_t& signature, uint64_t v) {
+            for (int i = 0; i < 8; ++i) {
+                signature ^= (v >> (8 * i)) & 0xFF;
+                signature *= 1099511628211ULL;
+            }
+        }
+
+    } // namespace
+
+    int suiteSize() {
+        return SUITE_SIZE;
+    }
+
+    const char* suitePosition(int index) {
+        return SUITE[index];
+    }
+
+    BenchResult run(int depth, int threads, size_t hashMB, bool quietMode) {
+        depth = std::max(1, depth);
+        threads = std::clamp(threads, 1, SUITE_SIZE);
+        std::vector<PositionResult> results(SUITE_SIZE);
+        std::atomic<int> nextPosition{0};
+
+        auto start = std::chrono::steady_clock::now();
+        auto runWorker = [&]() {
+            for (int i = nextPosition++; i < SUITE_SIZE; i = nextPosition++) results[i] = searchPosition(SUITE[i], depth, hashMB);
+        };
+        std::vector<std::thread> workers;
+        for (int t = 1; t < threads; ++t) workers.emplace_back(runWorker);
+        runWorker();
+        for (std::thread& worker : workers) worker.join();
+        int64_t elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+        BenchResult bench;
+        bench.positions = SUITE_SIZE;
+        bench.timeMs = elapsedMs;
+        bench.signature = 14695981039346656037ULL;
+        for (int i = 0; i < SUITE_SIZE; ++i) {
+            const PositionResult& r = results[i];
+            bench.nodes += r.nodes;
+            mixSignature(bench.signature, r.nodes);
+            mixSignature(bench.signature, (uint64_t(r.bestMove.fromRow & 0xFF) << 24) | (uint64_t(r.bestMove.fromCol & 0xFF) << 16)
+                                        | (uint64_t(r.bestMove.toRow & 0xFF) << 8) | uint64_t(r.bestMove.toCol & 0xFF));
+            if (!quietMode) {
+                std::cout << "Position " << std::setw(2) << (i + 1) << "/" << SUITE_SIZE << ": "
+                          << (r.bestMove.fromRow == -1 ? std::string("----") : Book::moveToAlgebraic(r.bestMove))
+                          << " score " << std::setw(8) << r.score << " nodes " << std::setw(10) << r.nodes << "  " << SUITE[i] << std::endl;
+            }
+        }
+
+        uint64_t nps = (elapsedMs > 0) ? bench.nodes * 1000 / elapsedMs : bench.nodes * 1000;
+        std::cout << "===========================" << std::endl;
+        std::cout << "Depth          : " << depth << " (threads " << threads << ", hash " << hashMB << " MB)" << std::endl;
+        std::cout << "Total time (ms): " << elapsedMs << std::endl;
+        std::cout << "Nodes searched : " << bench.nodes << std::endl;
+        std::cout << "Nodes/second   : " << nps << std::endl;
+        std::cout << "Signature      : " << std::hex << std::setw(16) << std::setfill('0') << bench.signature
+                  << std::dec << std::setfill(' ') << std::endl;
+        return bench;
+    }
+
+} // namespace Bench
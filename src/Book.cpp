@@ -1,5 +1,6 @@
 #include "Book.h"
 #include "Common.h"
+#include "Trace.h"
 #include <vector>
 #include <string>
 #include <fstream>
@@ -11,11 +12,13 @@
 
 namespace Book {
 
-    // --- Internal Data ---
-    // Definition of the storage for book variations (declared extern or accessed via getter)
-    std::vector<std::vector<Move>> bookVariations;
-    bool loaded = false;
-    std::mt19937 rng(std::random_device{}()); // Random number generator
+    // --- Book Instances ---
+    OpeningBook::OpeningBook() : rng(std::random_device{}()) {}
+
+    OpeningBook& defaultBook() {
+        static OpeningBook book;
+        return book;
+    }
 
     // --- Helper Functions for Algebraic Notation ---
 
@@ -60,7 +63,8 @@ namespace Book {
     // --- Main Book Functions ---
 
     // Load function remains largely the same, using algebraicToMove
-    bool load(const std::string& filename) {
+    bool OpeningBook::load(const std::string& filename) {
+        TRACE_SCOPE("book load", "book");
         bookVariations.clear(); // Clear existing data before loading
         loaded = false;
         std::ifstream inFile(filename);
@@ -112,7 +116,8 @@ namespace Book {
     }
 
     // Find book move remains the same
-    Move findBookMove(const std::vector<Move>& moveSequence) {
+    Move OpeningBook::findBookMove(const std::vector<Move>& moveSequence) {
+        TRACE_SCOPE("book lookup", "book");
         if (!loaded || bookVariations.empty()) {
             return {-1, -1, -1, -1};
         }
@@ -142,12 +147,12 @@ namespace Book {
         return {-1, -1, -1, -1};
     }
 
-    bool isLoaded() {
+    bool OpeningBook::isLoaded() const {
         return loaded;
     }
 
     // <<< NEW: Getter implementation >>>
-    const std::vector<std::vector<Move>>& getVariations() {
+    const std::vector<std::vector<Move>>& OpeningBook::getVariations() const {
         // Ensure book is loaded before returning? Or rely on caller checking isLoaded()?
         // Let's rely on the caller checking isLoaded() if they need valid data.
         return bookVariations;
@@ -155,7 +160,7 @@ namespace Book {
 
 
     // saveVariation implementation handles append/update logic
-    SaveResult saveVariation(const std::vector<Move>& newSequence, const std::string& filename) {
+    SaveResult OpeningBook::saveVariation(const std::vector<Move>& newSequence, const std::string& filename) {
         if (newSequence.empty()) {
             // std::cerr << "Book Editor Warning: Cannot save an empty move sequence." << std::endl;
             return SaveResult::ERROR_EMPTY;
@@ -273,6 +278,13 @@ namespace Book {
         }
     }
 
+    // --- Default Book (free functions) ---
+    bool load(const std::string& filename) { return defaultBook().load(filename); }
+    Move findBookMove(const std::vector<Move>& moveSequence) { return defaultBook().findBookMove(moveSequence); }
+    bool isLoaded() { return defaultBook().isLoaded(); }
+    SaveResult saveVariation(const std::vector<Move>& moveSequence, const std::string& filename) { return defaultBook().saveVariation(moveSequence, filename); }
+    const std::vector<std::vector<Move>>& getVariations() { return defaultBook().getVariations(); }
+
 } // namespace Book
 
 
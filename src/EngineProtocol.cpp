@@ -0,0 +1,270 @@
+// Text-protocol engine mode (build target: jungle_engine)
+//
+// A UCI-like line protocol over stdin/stdout, for match managers and scripts:
+//   uci | isready | ucinewgame | quit
+//   position startpos|fen <notation> [moves a3a4 g7g6 ...]   (GameState::toNotation, Book::algebraicToMove)
+//   go [depth N | movetime MS | nodes N | infinite]
+//   stop
+//   setoption name Hash value MB | setoption name Threads value N
+//   bench [depth] [threads] [hash]   (also as "jungle_engine bench ..." from the shell, see Bench.h)
+// "jungle_engine --trace FILE [bench ...]" records a timeline of the session (see Trace.h) and
+// writes it to FILE on quit.
+// While searching it prints "info depth D score cp X|mate N nodes N nps N time MS pv ..." per
+// completed iteration and finally "bestmove xxxx". Scores are from the side to move's view,
+// in centi-Cats (internal score / 30, the GUI's milliCat display / 10).
+
+#include "GameState.h"
+#include "AI.h"
+#include "Book.h"
+#include "Evaluation.h"
+#include "Bench.h"
+#include "Trace.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <stdexcept>
+#include <cstdlib>   // For std::abs
+#include <algorithm>
+#include <functional> // For std::ref
+
+namespace {
+
+    std::mutex outputMutex;
+
+    void sendLine(const std::string& line) {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        std::cout << line << std::endl;
+    }
+
+    struct GoLimits {
+        int depth = 0;          // 0 = no depth limit
+        int64_t moveTimeMs = 0; // 0 = no time limit
+        uint64_t nodes = 0;     // 0 = no node limit
+        bool infinite = false;
+    };
+
+    const int MAX_SEARCH_DEPTH = 64;
+
+    std::string formatScore(int rawScore, const GameState& rootState, const Move& bestMove, int searchDepth) {
+        Player sideToMove = rootState.getCurrentPlayer();
+        int score = (sideToMove == Player::PLAYER2) ? rawScore : -rawScore; // Internal scores are Player 2's view
+        if (Evaluation::isWinScore(score)) {
+            // WIN_SCORE + remaining depth: the game ends after (searchDepth - remaining) plies
+            // (remaining < 0 for a win from the TT beyond this search's horizon).
+            // The root reports an immediate den entry as plain WIN_SCORE.
+            GameState afterBest = rootState; afterBest.applyMove(bestMove);
+            int remaining = std::abs(score) - Evaluation::WIN_SCORE;
+            int plies = (afterBest.checkWinner() == sideToMove) ? 1 : std::max(1, searchDepth - remaining);
+            int moves = (plies + 1) / 2;
+            return "mate " + std::to_string(score > 0 ? moves : -moves);
+        }
+        return "cp " + std::to_string(score / 30);
+    }
+
+    // --- Iterative Deepening Driver (search thread) ---
+    // Each iteration is a full Engine::getBestMove(); the TT is kept between iterations (and moves)
+    // so the deeper search starts from the shallower one's best moves. An aborted iteration's
+    // result is only used when no iteration completed.
+    void runSearch(Engine& engine, GameState rootState, GoLimits limits) {
+        Trace::setThreadName("search");
+        TRACE_SCOPE("go", "search");
+        auto start = std::chrono::steady_clock::now();
+        Move bestMove = {-1,-1,-1,-1};
+        uint64_t totalNodes = 0;
+        int maxDepth = (limits.depth > 0) ? limits.depth : MAX_SEARCH_DEPTH;
+
+        for (int depth = 1; depth <= maxDepth; ++depth) {
+            int64_t elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+            int64_t timeLeft = (limits.moveTimeMs > 0) ? std::max<int64_t>(1, limits.moveTimeMs - elapsedMs) : 0;
+            uint64_t nodesLeft = (limits.nodes > 0) ? std::max<uint64_t>(1, limits.nodes - std::min(limits.nodes, totalNodes)) : 0;
+            engine.setSearchLimits(nodesLeft, timeLeft);
+
+            AIMoveInfo info = engine.getBestMove(rootState, depth, false, true);
+            totalNodes += info.nodesSearched;
+            if (info.bestMove.fromRow == -1) break; // No legal moves
+            if (info.aborted) { if (bestMove.fromRow == -1) bestMove = info.bestMove; break; }
+            bestMove = info.bestMove;
+
+            elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+            uint64_t nps = (elapsedMs > 0) ? totalNodes * 1000 / elapsedMs : totalNodes * 1000;
+            std::ostringstream line;
+            line << "info depth " << depth << " score " << formatScore(info.finalScore, rootState, info.bestMove, depth)
+                 << " nodes " << totalNodes << " nps " << nps << " time " << elapsedMs << " pv";
+            for (const Move& move : engine.getPrincipalVariation(rootState, info.bestMove, depth)) line << " " << Book::moveToAlgebraic(move);
+            sendLine(line.str());
+
+            if (Evaluation::isWinScore(info.finalScore)) break; // Forced result, deeper won't change it
+            if (limits.nodes > 0 && totalNodes >= limits.nodes) break;
+        }
+
+        // "go infinite" must not answer before "stop"
+        if (limits.infinite) {
+            engine.setSearchLimits(0, 0);
+            while (!engine.isStopRequested()) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        sendLine("bestmove " + (bestMove.fromRow == -1 ? std::string("0000") : Book::moveToAlgebraic(bestMove)));
+    }
+
+    // --- Command Parsing ---
+    bool parsePosition(std::istringstream& in, GameState& state) {
+        std::string token;
+        GameState newState;
+        if (!(in >> token)) return false;
+        if (token == "fen") {
+            std::string placement, side;
+            in >> placement >> side;
+            std::string notation = placement + " " + side;
+            if (!newState.fromNotation(notation.c_str())) { sendLine("info string invalid position " + notation); return false; }
+        } else if (token != "startpos") {
+            sendLine("info string expected 'position startpos|fen <notation> [moves ...]'"); return false;
+        }
+        if (in >> token && token == "moves") {
+            while (in >> token) {
+                Move move;
+                try { move = Book::algebraicToMove(token); }
+                catch (const std::invalid_argument&) { sendLine("info string invalid move " + token); return false; }
+                if (newState.checkWinner() != Player::NONE || !newState.isMoveLegal(move, newState.getCurrentPlayer())) {
+                    sendLine("info string illegal move " + token); return false;
+                }
+                newState.applyMove(move);
+                newState.switchPlayer();
+            }
+        }
+        state = newState;
+        return true;
+    }
+
+    GoLimits parseGo(std::istringstream& in) {
+        GoLimits limits;
+        std::string token;
+        try {
+            while (in >> token) {
+                if (token == "depth") { in >> token; limits.depth = std::stoi(token); }
+                else if (token == "movetime") { in >> token; limits.moveTimeMs = std::stoll(token); }
+                else if (token == "nodes") { in >> token; limits.nodes = std::stoull(token); }
+                else if (token == "infinite") limits.infinite = true;
+            }
+        } catch (const std::exception&) {
+            sendLine("info string invalid value '" + token + "' in go command");
+        }
+        return limits;
+    }
+
+    void parseSetOption(std::istringstream& in, Engine& engine) {
+        // setoption name <Name> value <Value>
+        std::string token, name, value;
+        in >> token; // "name"
+        while (in >> token && token != "value") name += (name.empty() ? "" : " ") + token;
+        std::getline(in >> std::ws, value);
+        try {
+            if (name == "Hash") {
+#ifdef USE_TRANSPOSITION_TABLE
+                size_t sizeMB = static_cast<size_t>(std::stoull(value));
+                if (!engine.setTTSizeMB(sizeMB)) sendLine("info string could not resize hash to " + value + " MB");
+#endif // USE_TRANSPOSITION_TABLE
+            } else if (name == "Threads") {
+                if (std::stoi(value) != 1) sendLine("info string search is single-threaded, Threads = 1");
+            } else {
+                sendLine("info string unknown option " + name);
+            }
+        } catch (const std::exception&) {
+            sendLine("info string invalid value '" + value + "' for " + name);
+        }
+    }
+
+    // bench [depth] [threads] [hash]: missing or invalid values keep the defaults
+    void runBench(const std::vector<std::string>& args) {
+        int values[3] = {Bench::DEFAULT_DEPTH, 1, static_cast<int>(Bench::DEFAULT_HASH_MB)};
+        for (size_t k = 0; k < args.size() && k < 3; ++k) {
+            try { values[k] = std::max(1, std::stoi(args[k])); }
+            catch (const std::exception&) { sendLine("info string invalid bench value " + args[k]); }
+        }
+        Bench::run(values[0], values[1], static_cast<size_t>(values[2]));
+    }
+
+} // namespace
+
+
+int main(int argc, char* argv[]) {
+    std::ios::sync_with_stdio(false);
+    std::string traceFile;
+    int firstArg = 1;
+    if (argc > 2 && std::string(argv[1]) == "--trace") {
+        traceFile = argv[2];
+        firstArg = 3;
+        if (Trace::start()) Trace::setThreadName("main");
+        else { std::cerr << "Warning: Tracing disabled at compile time, ignoring --trace." << std::endl; traceFile.clear(); }
+    }
+    auto writeTrace = [&]() {
+        if (traceFile.empty()) return;
+        Trace::stop();
+        Trace::writeJson(traceFile);
+    };
+    if (argc > firstArg && std::string(argv[firstArg]) == "bench") {
+        runBench(std::vector<std::string>(argv + firstArg + 1, argv + argc));
+        writeTrace();
+        return 0;
+    }
+    Engine engine;
+    GameState state;
+    std::thread searchThread;
+    auto stopSearch = [&]() {
+        if (searchThread.joinable()) { engine.requestStop(); searchThread.join(); }
+    };
+#ifdef USE_TRANSPOSITION_TABLE
+    engine.setPersistentTT(true); // Iterations and consecutive moves share the TT; ucinewgame clears it
+#endif
+
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        std::istringstream in(line);
+        std::string command;
+        if (!(in >> command)) continue;
+
+        if (command == "uci") {
+            sendLine("id name JungleChess");
+            sendLine("id author JSettler");
+            sendLine("option name Hash type spin default 160 min 1 max 65536");
+            sendLine("option name Threads type spin default 1 min 1 max 1");
+            sendLine("uciok");
+        } else if (command == "isready") {
+            sendLine("readyok");
+        } else if (command == "ucinewgame") {
+            stopSearch();
+            state = GameState();
+#ifdef USE_TRANSPOSITION_TABLE
+            engine.clearTT();
+#endif
+        } else if (command == "position") {
+            stopSearch();
+            parsePosition(in, state);
+        } else if (command == "go") {
+            stopSearch();
+            GoLimits limits = parseGo(in);
+            engine.clearStop();
+            searchThread = std::thread(runSearch, std::ref(engine), state, limits);
+        } else if (command == "stop") {
+            stopSearch();
+        } else if (command == "setoption") {
+            stopSearch();
+            parseSetOption(in, engine);
+        } else if (command == "bench") {
+            stopSearch();
+            std::vector<std::string> args;
+            std::string token;
+            while (in >> token) args.push_back(token);
+            runBench(args);
+        } else if (command == "quit") {
+            break;
+        } else {
+            sendLine("info string unknown command " + command);
+        }
+    }
+    stopSearch();
+    writeTrace();
+    return 0;
+}
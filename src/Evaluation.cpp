@@ -0,0 +1,185 @@
+#include "Evaluation.h"
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+// AVX2 kernel is compiled with a per-function target attribute and selected at runtime,
+// so the binary still runs on CPUs without AVX2 (scalar fallback).
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define EVAL_KERNEL_HAVE_AVX2
+#endif
+
+namespace Evaluation {
+
+    // --- Active Parameters and Derived Tables ---
+    // All built by constexpr functions from the defaults, so they are constant-initialized
+    // (ready before any static constructor could look at them).
+    EvalParams params = DEFAULT_EVAL_PARAMS;
+    MaterialPstTable materialPstValue = buildMaterialPstTable(DEFAULT_EVAL_PARAMS);
+    MaterialPstTable denThreatValue = buildDenThreatTable(DEFAULT_EVAL_PARAMS);
+    RatSquareTable elephantTrapValue = buildElephantTrapTable(DEFAULT_EVAL_PARAMS);
+    RatLaneTable ratInterceptValue = buildRatInterceptTable(DEFAULT_EVAL_PARAMS);
+
+    // Flattened, packed copy of the [type][player][square] tables with a padded square dimension,
+    // so the kernel needs one gather per lane: ((type * 3 + owner) * PLANE_SIZE + square).
+    // Low 16 bits: material + PST (always positive for a real piece), high 16 bits: den threat.
+    using PackedTable = std::array<int32_t, (static_cast<int>(PieceType::ELEPHANT) + 1) * 3 * PLANE_SIZE>;
+
+    static constexpr PackedTable buildPackedTermsTable(const MaterialPstTable& materialPst, const MaterialPstTable& denThreat) {
+        PackedTable packed{};
+        for (int t = 0; t <= static_cast<int>(PieceType::ELEPHANT); ++t)
+            for (int p = 0; p < 3; ++p)
+                for (int sq = 0; sq < BOARD_ROWS * BOARD_COLS; ++sq)
+                    packed[(t * 3 + p) * PLANE_SIZE + sq] = (denThreat[t][p][sq] << 16) | materialPst[t][p][sq];
+        return packed;
+    }
+
+    static PackedTable packedTerms = buildPackedTermsTable(buildMaterialPstTable(DEFAULT_EVAL_PARAMS), buildDenThreatTable(DEFAULT_EVAL_PARAMS));
+
+    constexpr bool packedTermsFit(const MaterialPstTable& materialPst, const MaterialPstTable& denThreat) {
+        for (int t = 0; t <= static_cast<int>(PieceType::ELEPHANT); ++t)
+            for (int p = 0; p < 3; ++p)
+                for (int sq = 0; sq < BOARD_ROWS * BOARD_COLS; ++sq)
+                    if (materialPst[t][p][sq] < 0 || materialPst[t][p][sq] > 0xFFFF || denThreat[t][p][sq] < 0 || denThreat[t][p][sq] > 0x7FFF) return false;
+        return true;
+    }
+    static_assert(packedTermsFit(buildMaterialPstTable(DEFAULT_EVAL_PARAMS), buildDenThreatTable(DEFAULT_EVAL_PARAMS)),
+                  "Material/PST or den threat values no longer fit the packed kernel table");
+
+    bool setParams(const EvalParams& newParams) {
+        MaterialPstTable newMaterialPst = buildMaterialPstTable(newParams);
+        MaterialPstTable newDenThreat = buildDenThreatTable(newParams);
+        // Rat/elephant tables are int16
+        if (!packedTermsFit(newMaterialPst, newDenThreat) ||
+            newParams.elephantTrapPenalty < -0x8000 || newParams.elephantTrapPenalty > 0x7FFF ||
+            newParams.ratInterceptMaxBonus < -0x8000 || newParams.ratInterceptMaxBonus > 0x7FFF) return false;
+        params = newParams;
+        materialPstValue = newMaterialPst;
+        denThreatValue = newDenThreat;
+        elephantTrapValue = buildElephantTrapTable(newParams);
+        ratInterceptValue = buildRatInterceptTable(newParams);
+        packedTerms = buildPackedTermsTable(newMaterialPst, newDenThreat);
+        return true;
+    }
+
+    void fillBoardPlanes(const std::vector<std::vector<Piece>>& board, BoardPlanes& planes) {
+        for (int r = 0; r < BOARD_ROWS; ++r) {
+            for (int c = 0; c < BOARD_COLS; ++c) {
+                const Piece& piece = board[r][c];
+                int sq = r * BOARD_COLS + c;
+                planes.type[sq] = static_cast<int8_t>(piece.type);
+                planes.owner[sq] = static_cast<int8_t>(piece.owner);
+                planes.weakened[sq] = piece.weakened ? 1 : 0;
+            }
+        }
+        for (int sq = BOARD_ROWS * BOARD_COLS; sq < PLANE_SIZE; ++sq) {
+            planes.type[sq] = 0; planes.owner[sq] = 0; planes.weakened[sq] = 0;
+        }
+    }
+
+    // Scalar fallback: same table as the AVX2 kernel, but skipping empty squares
+    // (a board rarely holds more than 16 pieces, so this beats a branch-free scalar loop).
+    BoardTerms computeBoardTermsScalar(const BoardPlanes& planes) {
+        BoardTerms terms;
+        for (int sq = 0; sq < PLANE_SIZE; ++sq) {
+            int owner = planes.owner[sq];
+            if (owner == 0) continue;
+            int32_t packed = packedTerms[(planes.type[sq] * 3 + owner) * PLANE_SIZE + sq];
+            int threat = packed >> 16;
+            terms.materialPst[owner] += packed & 0xFFFF;
+            terms.denThreat[owner] += threat;
+            terms.denZoneCount[owner] += (threat != 0);
+        }
+        return terms;
+    }
+
+#ifdef EVAL_KERNEL_HAVE_AVX2
+    __attribute__((target("avx2")))
+    static int horizontalSum(__m256i v) {
+        __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(sum);
+    }
+
+    // Branch-free: empty squares index the all-zero type-0 rows of the table.
+    // 8 squares per iteration: widen type/owner bytes, build table indices, gather the packed
+    // terms and accumulate into per-side lanes masked by owner; horizontal sums at the end.
+    __attribute__((target("avx2")))
+    static BoardTerms computeBoardTermsAVX2Kernel(const BoardPlanes& planes) {
+        const __m256i laneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256i ones = _mm256_set1_epi32(1);
+        const __m256i player1 = _mm256_set1_epi32(static_cast<int>(Player::PLAYER1));
+        const __m256i player2 = _mm256_set1_epi32(static_cast<int>(Player::PLAYER2));
+        __m256i materialP1 = _mm256_setzero_si256(), materialP2 = _mm256_setzero_si256();
+        __m256i threatP1 = _mm256_setzero_si256(), threatP2 = _mm256_setzero_si256();
+        __m256i zoneP1 = _mm256_setzero_si256(), zoneP2 = _mm256_setzero_si256();
+
+        for (int base = 0; base < PLANE_SIZE; base += 8) {
+            __m256i type = _mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(planes.type + base)));
+            __m256i owner = _mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(planes.owner + base)));
+            // index = (type * 3 + owner) * PLANE_SIZE + square
+            __m256i kind = _mm256_add_epi32(_mm256_add_epi32(type, _mm256_add_epi32(type, type)), owner);
+            __m256i index = _mm256_add_epi32(_mm256_slli_epi32(kind, 6), _mm256_add_epi32(laneOffsets, _mm256_set1_epi32(base)));
+            __m256i packed = _mm256_i32gather_epi32(packedTerms.data(), index, 4);
+            __m256i value = _mm256_and_si256(packed, _mm256_set1_epi32(0xFFFF));
+            __m256i threat = _mm256_srli_epi32(packed, 16);
+
+            __m256i isP1 = _mm256_cmpeq_epi32(owner, player1);
+            __m256i isP2 = _mm256_cmpeq_epi32(owner, player2);
+            __m256i inZone = _mm256_andnot_si256(_mm256_cmpeq_epi32(threat, _mm256_setzero_si256()), ones);
+            materialP1 = _mm256_add_epi32(materialP1, _mm256_and_si256(value, isP1));
+            materialP2 = _mm256_add_epi32(materialP2, _mm256_and_si256(value, isP2));
+            threatP1 = _mm256_add_epi32(threatP1, _mm256_and_si256(threat, isP1));
+            threatP2 = _mm256_add_epi32(threatP2, _mm256_and_si256(threat, isP2));
+            zoneP1 = _mm256_add_epi32(zoneP1, _mm256_and_si256(inZone, isP1));
+            zoneP2 = _mm256_add_epi32(zoneP2, _mm256_and_si256(inZone, isP2));
+        }
+
+        BoardTerms terms;
+        terms.materialPst[1] = horizontalSum(materialP1); terms.materialPst[2] = horizontalSum(materialP2);
+        terms.denThreat[1] = horizontalSum(threatP1);     terms.denThreat[2] = horizontalSum(threatP2);
+        terms.denZoneCount[1] = horizontalSum(zoneP1);    terms.denZoneCount[2] = horizontalSum(zoneP2);
+        return terms;
+    }
+#endif // EVAL_KERNEL_HAVE_AVX2
+
+    bool computeBoardTermsAVX2(const BoardPlanes& planes, BoardTerms& terms) {
+#ifdef EVAL_KERNEL_HAVE_AVX2
+        static const bool useAVX2 = __builtin_cpu_supports("avx2");
+        if (useAVX2) { terms = computeBoardTermsAVX2Kernel(planes); return true; }
+#else
+        (void)planes; (void)terms;
+#endif
+        return false;
+    }
+
+    BoardTerms computeBoardTerms(const BoardPlanes& planes) {
+        BoardTerms terms;
+        if (computeBoardTermsAVX2(planes, terms)) return terms;
+        return computeBoardTermsScalar(planes);
+    }
+
+    // --- Batch Evaluation ---
+    static void evaluateRange(const GameState* states, size_t begin, size_t end, int* scores) {
+        for (size_t i = begin; i < end; ++i) scores[i] = evaluateBoard(states[i]);
+    }
+
+    void evaluateBatch(const GameState* states, size_t count, int* scores, unsigned maxThreads) {
+        unsigned threadCount = maxThreads != 0 ? maxThreads : std::max(1u, std::thread::hardware_concurrency());
+        threadCount = static_cast<unsigned>(std::min<size_t>(threadCount, count / BATCH_MIN_POSITIONS_PER_THREAD));
+        if (threadCount <= 1) { evaluateRange(states, 0, count, scores); return; }
+
+        // Contiguous chunks; the calling thread takes the last one
+        std::vector<std::thread> workers;
+        workers.reserve(threadCount - 1);
+        size_t chunk = (count + threadCount - 1) / threadCount;
+        for (unsigned t = 0; t + 1 < threadCount; ++t) {
+            workers.emplace_back(evaluateRange, states, t * chunk, std::min(count, (t + 1) * chunk), scores);
+        }
+        evaluateRange(states, (threadCount - 1) * chunk, count, scores);
+        for (std::thread& worker : workers) worker.join();
+    }
+
+} // namespace Evaluation
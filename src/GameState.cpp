@@ -1,6 +1,7 @@
 #include "GameState.h"
 #include "Common.h"
 #include "Hashing.h" // Include Zobrist hashing
+#include "Evaluation.h" // Precombined material/PST table for the incremental terms
 #include <vector>
 #include <cmath>
 #include <stdexcept>
@@ -10,8 +11,7 @@
 
 // --- Constructor Implementation ---
 GameState::GameState() {
-    // Ensure Zobrist keys are initialized (safe to call multiple times)
-    Zobrist::initializeKeys();
+    // Zobrist keys are compile-time constants, nothing to initialize
     currentPlayer = Player::PLAYER1;
     setupInitialBoard(); // This will now calculate the initial hash
 }
@@ -33,6 +33,7 @@ void GameState::setupInitialBoard() {
     board[6][2] = {PieceType::WOLF, Player::PLAYER2, 4, false}; board[6][0] = {PieceType::ELEPHANT, Player::PLAYER2, 8, false};
 
     recalculateHash(); // Calculate initial hash after board is set up
+    recalculateEvalTerms();
 }
 
 // --- getPiece Implementation ---
@@ -140,18 +141,73 @@ bool GameState::isMoveLegal(const Move& move, Player player) const {
 // --- Hash update helper ---
 void GameState::updateHashForPieceChange(PieceType type, Player player, int r, int c) {
     // Hash doesn't depend on 'weakened' status, so this function is unchanged
-    if (type != PieceType::EMPTY && player != Player::NONE) {
-        int ppi = Zobrist::getPiecePlayerIndex(type, player);
-        // Basic bounds check
-        if (ppi != -1 && ppi < Zobrist::piecePlayerKeys.size() &&
-            r >= 0 && r < BOARD_ROWS && c >= 0 && c < BOARD_COLS)
-        {
-            currentHashKey ^= Zobrist::piecePlayerKeys[ppi][r][c];
-        } else {
-             // Suppress warning in non-debug? Or keep it? Let's keep it.
-             std::cerr << "Warning: Invalid index during hash update. ppi=" << ppi << " R=" << r << " C=" << c << std::endl;
+    int ppi = Zobrist::getPiecePlayerIndex(type, player);
+    if (ppi != -1) {
+        currentHashKey ^= Zobrist::getKey(ppi, r, c);
+    }
+}
+
+// --- Incremental eval term helper ---
+void GameState::updateEvalTermsForPieceChange(const Piece& piece, int r, int c, int sign) {
+    PieceType type = piece.type; Player player = piece.owner;
+    if (type == PieceType::EMPTY || player == Player::NONE) return;
+    int t = static_cast<int>(type); int p = static_cast<int>(player); int sq = r * BOARD_COLS + c;
+    materialPst[p] += sign * Evaluation::materialPstValue[t][p][sq];
+    int threat = Evaluation::denThreatValue[t][p][sq];
+    if (threat != 0) { denThreat[p] += sign * threat; denZoneCount[p] += sign; }
+    int trapIndex = Evaluation::trapIndexBySquare[sq];
+    if (trapIndex != -1 && Evaluation::TRAP_SQUARES[trapIndex].owner != player) {
+        // At most one piece per square, so set on add / clear on remove is exact
+        if (sign > 0) trapIntruderMask |= (1u << trapIndex);
+        else trapIntruderMask &= ~(1u << trapIndex);
+    }
+    // Bitboards: toggling is exact because each change adds or removes one piece
+    uint64_t bit = 1ULL << sq;
+    pieceBitboards[Zobrist::getPiecePlayerIndex(type, player)] ^= bit;
+    occupancyBitboards[p] ^= bit;
+    if (piece.weakened) weakenedBitboards[p] ^= bit;
+    if (nnueAccumulator.isCurrent()) { // A stale one is rebuilt at the end of applyMove()
+        NNUE::updateAccumulator(nnueAccumulator.values.data(), NNUE::pieceFeature(type, player, sq), sign);
+        if (piece.weakened) NNUE::updateAccumulator(nnueAccumulator.values.data(), NNUE::weakenedFeature(player, sq), sign);
+    }
+}
+
+// Rebuilds all incremental eval terms from scratch (after bulk board changes)
+void GameState::recalculateEvalTerms() {
+    // Material/PST and den terms: vectorized structure-of-arrays kernel over all squares
+    Evaluation::BoardPlanes planes;
+    Evaluation::fillBoardPlanes(board, planes);
+    Evaluation::BoardTerms terms = Evaluation::computeBoardTerms(planes);
+    for (int p = 0; p < 3; ++p) {
+        materialPst[p] = terms.materialPst[p]; denThreat[p] = terms.denThreat[p]; denZoneCount[p] = terms.denZoneCount[p];
+    }
+    // Trap intruders: only six squares to look at
+    trapIntruderMask = 0;
+    for (int i = 0; i < 6; ++i) {
+        const Piece& piece = board[Evaluation::TRAP_SQUARES[i].r][Evaluation::TRAP_SQUARES[i].c];
+        if (piece.owner != Player::NONE && piece.owner != Evaluation::TRAP_SQUARES[i].owner) trapIntruderMask |= (1u << i);
+    }
+    // Bitboards
+    for (uint64_t& bb : pieceBitboards) bb = 0;
+    for (int p = 0; p < 3; ++p) { occupancyBitboards[p] = 0; weakenedBitboards[p] = 0; }
+    for (int r = 0; r < BOARD_ROWS; ++r) {
+        for (int c = 0; c < BOARD_COLS; ++c) {
+            const Piece& piece = board[r][c];
+            if (piece.type == PieceType::EMPTY || piece.owner == Player::NONE) continue;
+            uint64_t bit = Bitboard::squareBit(r, c); int p = static_cast<int>(piece.owner);
+            pieceBitboards[Zobrist::getPiecePlayerIndex(piece.type, piece.owner)] |= bit;
+            occupancyBitboards[p] |= bit;
+            if (piece.weakened) weakenedBitboards[p] |= bit;
         }
     }
+    rebuildNnueAccumulator();
+}
+
+// Accumulator from scratch for the loaded network (marked as never built while NNUE is off)
+void GameState::rebuildNnueAccumulator() {
+    if (!NNUE::isActive()) { nnueAccumulator.builtFor = 0; return; }
+    NNUE::buildAccumulator(*this, nnueAccumulator.values.data());
+    nnueAccumulator.builtFor = NNUE::network;
 }
 
 // --- applyMove Implementation ---
@@ -162,6 +218,9 @@ void GameState::applyMove(const Move& move) {
     // --- Update Hash (BEFORE modifying board state) ---
     updateHashForPieceChange(movingPiece.type, movingPiece.owner, move.fromRow, move.fromCol);
     updateHashForPieceChange(capturedPiece.type, capturedPiece.owner, move.toRow, move.toCol);
+    // Same deltas for the incremental eval terms (search is copy-make, so there is no unmake to mirror)
+    updateEvalTermsForPieceChange(movingPiece, move.fromRow, move.fromCol, -1);
+    updateEvalTermsForPieceChange(capturedPiece, move.toRow, move.toCol, -1);
 
     // --- Update Board ---
     // Check if moving onto an opponent's trap to set weakened flag
@@ -177,6 +236,8 @@ void GameState::applyMove(const Move& move) {
     // --- Update Hash (Part 2: Add moving piece in new location) ---
     // Must use the piece info *after* potential weakening status change, though hash doesn't use weakened flag
     updateHashForPieceChange(movingPiece.type, movingPiece.owner, move.toRow, move.toCol);
+    updateEvalTermsForPieceChange(movingPiece, move.toRow, move.toCol, +1); // Weakened flag matters for NNUE features
+    if (NNUE::isActive() && !nnueAccumulator.isCurrent()) rebuildNnueAccumulator(); // Built before NNUE::load()
     // Side to move hash is updated in switchPlayer()
 }
 
@@ -264,6 +325,54 @@ uint64_t GameState::getHashKey() const {
     return currentHashKey;
 }
 
+uint64_t GameState::getHashKeyWithWeakened() const {
+    uint64_t weak1 = weakenedBitboards[static_cast<int>(Player::PLAYER1)];
+    uint64_t weak2 = weakenedBitboards[static_cast<int>(Player::PLAYER2)];
+    if ((weak1 | weak2) == 0) return currentHashKey;
+    auto mix = [](uint64_t x) { // splitmix64 finalizer
+        x ^= x >> 30; x *= 0xBF58476D1CE4E5B9ULL;
+        x ^= x >> 27; x *= 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    };
+    return currentHashKey ^ mix(weak1) ^ mix(weak2 ^ 0x5555555555555555ULL);
+}
+
+// --- Incremental eval term getter ---
+int GameState::getMaterialPst(Player player) const {
+    return materialPst[static_cast<int>(player)];
+}
+int GameState::getDenThreat(Player player) const {
+    return denThreat[static_cast<int>(player)];
+}
+int GameState::getDenZoneCount(Player player) const {
+    return denZoneCount[static_cast<int>(player)];
+}
+unsigned GameState::getTrapIntruderMask() const {
+    return trapIntruderMask;
+}
+const NNUE::Accumulator& GameState::getNnueAccumulator() const {
+    return nnueAccumulator;
+}
+
+
+// --- Child hash implementation ---
+uint64_t GameState::getHashKeyAfterMove(const Move& move) const {
+    // Mirrors the XOR sequence of applyMove() followed by switchPlayer()
+    const Piece& movingPiece = board[move.fromRow][move.fromCol];
+    const Piece& capturedPiece = board[move.toRow][move.toCol];
+    uint64_t key = currentHashKey ^ Zobrist::sideToMoveKey;
+    int moverIndex = Zobrist::getPiecePlayerIndex(movingPiece.type, movingPiece.owner);
+    if (moverIndex != -1) {
+        key ^= Zobrist::getKey(moverIndex, move.fromRow, move.fromCol);
+        key ^= Zobrist::getKey(moverIndex, move.toRow, move.toCol);
+    }
+    int capturedIndex = Zobrist::getPiecePlayerIndex(capturedPiece.type, capturedPiece.owner);
+    if (capturedIndex != -1) {
+        key ^= Zobrist::getKey(capturedIndex, move.toRow, move.toCol);
+    }
+    return key;
+}
+
 
 // --- Public Helper Functions ---
 bool GameState::isValidPosition(int r, int c) const { return r >= 0 && r < BOARD_ROWS && c >= 0 && c < BOARD_COLS; }
@@ -329,6 +438,7 @@ bool GameState::canCapture(const Piece& attacker, const Piece& defender, int def
 void GameState::setBoard(const std::vector<std::vector<Piece>>& newBoard) {
     if (newBoard.size() == BOARD_ROWS && (!newBoard.empty() && newBoard[0].size() == BOARD_COLS)) {
         board = newBoard;
+        recalculateEvalTerms();
         // WARNING: Hash is NOT updated here. Caller must call recalculateHash or setHashKey.
     } else {
         std::cerr << "Error: Attempted to set board with invalid dimensions." << std::endl;
@@ -357,6 +467,110 @@ void GameState::setHashKey(uint64_t key) {
     currentHashKey = key;
 }
 
+// --- Position Notation ---
+namespace {
+    const char NOTATION_PIECE_CHARS[] = ".rcdwptle"; // Indexed by PieceType (Player 2 / lower case)
+
+    PieceType pieceTypeFromNotation(char ch) {
+        for (int t = 1; t <= static_cast<int>(PieceType::ELEPHANT); ++t) {
+            if (NOTATION_PIECE_CHARS[t] == ch) return static_cast<PieceType>(t);
+        }
+        return PieceType::EMPTY;
+    }
+}
+
+size_t GameState::toNotation(char* buffer, size_t bufferSize) const {
+    char text[MAX_NOTATION_LENGTH + 1];
+    size_t length = 0;
+    for (int r = BOARD_ROWS - 1; r >= 0; --r) {
+        int emptyRun = 0;
+        for (int c = 0; c < BOARD_COLS; ++c) {
+            const Piece& piece = board[r][c];
+            if (piece.type == PieceType::EMPTY) { ++emptyRun; continue; }
+            if (emptyRun > 0) { text[length++] = static_cast<char>('0' + emptyRun); emptyRun = 0; }
+            char ch = NOTATION_PIECE_CHARS[static_cast<int>(piece.type)];
+            text[length++] = (piece.owner == Player::PLAYER1) ? static_cast<char>(ch - 'a' + 'A') : ch;
+            if (piece.weakened) text[length++] = '*';
+        }
+        if (emptyRun > 0) text[length++] = static_cast<char>('0' + emptyRun);
+        if (r > 0) text[length++] = '/';
+    }
+    text[length++] = ' ';
+    text[length++] = (currentPlayer == Player::PLAYER2) ? '2' : '1';
+    if (length + 1 > bufferSize) return 0;
+    for (size_t i = 0; i < length; ++i) buffer[i] = text[i];
+    buffer[length] = '\0';
+    return length;
+}
+
+std::string GameState::toNotation() const {
+    char buffer[MAX_NOTATION_LENGTH + 1];
+    size_t length = toNotation(buffer, sizeof(buffer));
+    return std::string(buffer, length);
+}
+
+bool GameState::fromNotation(const char* text, const char** end) {
+    if (text == nullptr) return false;
+    Piece parsed[BOARD_ROWS][BOARD_COLS] = {}; // Validate completely before touching the board
+    int placed[BOARD_ROWS * BOARD_COLS]; int placedCount = 0;
+    int pieceCounts[3][static_cast<int>(PieceType::ELEPHANT) + 1] = {}; // [player][type]
+    const char* p = text;
+    for (int r = BOARD_ROWS - 1; r >= 0; --r) {
+        int c = 0;
+        while (c < BOARD_COLS) {
+            char ch = *p;
+            if (ch >= '1' && ch <= '7') {
+                c += ch - '0';
+                if (c > BOARD_COLS) return false;
+                ++p;
+                continue;
+            }
+            bool upper = (ch >= 'A' && ch <= 'Z');
+            PieceType type = pieceTypeFromNotation(upper ? static_cast<char>(ch - 'A' + 'a') : ch);
+            if (type == PieceType::EMPTY) return false;
+            ++p;
+            bool weakened = (*p == '*');
+            if (weakened) ++p;
+            Player owner = upper ? Player::PLAYER1 : Player::PLAYER2;
+            // Impossible positions are malformed too: one piece of each type per side, only the Rat
+            // in the river, and nothing in its own den (same rules as setPieceAt)
+            if (++pieceCounts[static_cast<int>(owner)][static_cast<int>(type)] > 1) return false;
+            if (type != PieceType::RAT && isRiver(r, c)) return false;
+            if (isOwnDen(r, c, owner)) return false;
+            placed[placedCount++] = r * BOARD_COLS + c;
+            parsed[r][c++] = {type, owner, getRank(type), weakened};
+        }
+        if (r > 0 && *p++ != '/') return false;
+    }
+    if (*p++ != ' ') return false;
+    while (*p == ' ') ++p;
+    if (*p != '1' && *p != '2') return false;
+    Player sideToMove = (*p++ == '2') ? Player::PLAYER2 : Player::PLAYER1;
+    if (*p != '\0' && *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r') return false;
+
+    for (int r = 0; r < BOARD_ROWS; ++r)
+        for (int c = 0; c < BOARD_COLS; ++c)
+            board[r][c] = parsed[r][c];
+    currentPlayer = sideToMove;
+
+    // Incremental terms and hash from the placed pieces only (cheaper than the full-board recalculations)
+    for (int pl = 0; pl < 3; ++pl) { materialPst[pl] = 0; denThreat[pl] = 0; denZoneCount[pl] = 0; occupancyBitboards[pl] = 0; weakenedBitboards[pl] = 0; }
+    for (uint64_t& bb : pieceBitboards) bb = 0;
+    trapIntruderMask = 0;
+    nnueAccumulator.builtFor = NNUE::isActive() ? NNUE::network : 0;
+    if (nnueAccumulator.isCurrent()) NNUE::resetAccumulator(nnueAccumulator.values.data()); // Pieces are added below
+    currentHashKey = (currentPlayer == Player::PLAYER2) ? Zobrist::sideToMoveKey : 0;
+    for (int i = 0; i < placedCount; ++i) {
+        int r = placed[i] / BOARD_COLS, c = placed[i] % BOARD_COLS;
+        const Piece& piece = board[r][c];
+        updateEvalTermsForPieceChange(piece, r, c, +1);
+        currentHashKey ^= Zobrist::getKey(Zobrist::getPiecePlayerIndex(piece.type, piece.owner), r, c);
+    }
+    if (end != nullptr) *end = p;
+    return true;
+}
+
+
 // --- Setup Mode Method Implementations ---
 
 // Counts pieces for a given player
@@ -404,7 +618,9 @@ bool GameState::setPieceAt(int r, int c, PieceType type, Player player) {
 
     // Create the new piece (start not weakened)
     Piece newPiece = {type, player, getRank(type), false}; // Ensure weakened is false on setup placement
+    updateEvalTermsForPieceChange(existingPiece, r, c, -1);
     board[r][c] = newPiece; // Place new (overwrites old)
+    updateEvalTermsForPieceChange(newPiece, r, c, +1);
     // Hash will be recalculated when finishing setup.
     return true;
 }
@@ -412,6 +628,7 @@ bool GameState::setPieceAt(int r, int c, PieceType type, Player player) {
 // Removes piece at location
 void GameState::clearSquare(int r, int c) {
     if (isValidPosition(r, c)) {
+        updateEvalTermsForPieceChange(board[r][c], r, c, -1);
         board[r][c] = {PieceType::EMPTY, Player::NONE, 0, false}; // Ensure weakened is false
         // Hash will be recalculated when finishing setup.
     }
@@ -420,6 +637,7 @@ void GameState::clearSquare(int r, int c) {
 // Removes all pieces
 void GameState::clearBoard() {
      board.assign(BOARD_ROWS, std::vector<Piece>(BOARD_COLS, {PieceType::EMPTY, Player::NONE, 0, false})); // Ensure weakened is false
+     recalculateEvalTerms();
      // Hash will be recalculated when finishing setup.
 }
 
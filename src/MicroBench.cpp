@@ -0,0 +1,408 @@
+// Microbenchmarks for the engine's hot-path primitives (build target: jungle_bench)
+//
+// Each benchmark runs one primitive over a corpus of realistic positions (the bench suite from
+// Bench.h plus positions a few random plies further on) until --min-time has passed, and reports
+// ns/op, heap allocations/op and CPU cycles/op. Cycles come from Linux perf counters
+// (perf_event_open) and show "n/a" where those aren't available (other OSes, containers,
+// perf_event_paranoid). Use it before and after a change to a primitive.
+
+#include "GameState.h"
+#include "AI.h"
+#include "Book.h"
+#include "Bench.h"
+#include "Evaluation.h"
+#include <iostream>
+#include <iomanip>   // For std::setw, std::setprecision
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <atomic>
+#include <new>
+#include <cstdlib>   // For std::malloc, std::free
+#include <cstring>   // For strcmp, std::memset
+#include <stdexcept> // For std::stoi exceptions
+#include <functional>
+#include <algorithm>
+#include <thread>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define JUNGLE_HAVE_PERF_EVENTS
+#endif
+
+// --- Allocation Counting ---
+// Every global new in this process goes through here; benchmarks read the counter around their loop.
+namespace {
+    std::atomic<uint64_t> allocationCount{0};
+}
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+    // --- Cycle Counter ---
+    class CycleCounter {
+    public:
+        CycleCounter() {
+#ifdef JUNGLE_HAVE_PERF_EVENTS
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+        }
+        ~CycleCounter() {
+#ifdef JUNGLE_HAVE_PERF_EVENTS
+            if (fd >= 0) close(fd);
+#endif
+        }
+        bool available() const { return fd >= 0; }
+        void start() {
+#ifdef JUNGLE_HAVE_PERF_EVENTS
+            if (fd < 0) return;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+        }
+        uint64_t stop() {
+            uint64_t cycles = 0;
+#ifdef JUNGLE_HAVE_PERF_EVENTS
+            if (fd < 0) return 0;
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd, &cycles, sizeof(cycles)) != sizeof(cycles)) cycles = 0;
+#endif
+            return cycles;
+        }
+    private:
+        int fd = -1;
+    };
+
+    // Results feed into this so the compiler can't drop the measured calls
+    volatile uint64_t sink = 0;
+
+    struct BenchOptions {
+        int64_t minTimeMs = 300; // Per benchmark
+        std::string filter;      // Only benchmarks whose name contains this
+        std::string bookFile = "opening_book.txt";
+        int searchDepth = 4;     // Search benchmark depth, 0 = skip it
+        unsigned batchThreads = std::max(2u, std::thread::hardware_concurrency()); // evaluateBatch's threaded entry
+    };
+
+    // Runs pass() (which performs opsPerPass operations) until minTimeMs has passed, then prints one line
+    void measure(const char* name, uint64_t opsPerPass, const std::function<void()>& pass, const BenchOptions& options, CycleCounter& cycles) {
+        if (!options.filter.empty() && std::string(name).find(options.filter) == std::string::npos) return;
+        if (opsPerPass == 0) { std::cout << std::left << std::setw(26) << name << std::right << "  (no data)" << std::endl; return; }
+        pass(); // Warm-up: caches, lazy allocations
+        uint64_t ops = 0;
+        uint64_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+        cycles.start();
+        auto start = std::chrono::steady_clock::now();
+        double elapsedNs = 0.0;
+        do {
+            pass();
+            ops += opsPerPass;
+            elapsedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        } while (elapsedNs < options.minTimeMs * 1e6);
+        uint64_t cycleCount = cycles.stop();
+        uint64_t allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+
+        std::cout << std::left << std::setw(26) << name << std::right << std::fixed
+                  << std::setw(12) << ops << " ops"
+                  << std::setprecision(2) << std::setw(10) << elapsedNs / ops << " ns/op"
+                  << std::setw(8) << static_cast<double>(allocations) / ops << " allocs/op";
+        if (cycles.available()) std::cout << std::setprecision(1) << std::setw(9) << static_cast<double>(cycleCount) / ops << " cycles/op";
+        else std::cout << "       n/a cycles/op";
+        std::cout << std::defaultfloat << std::endl;
+    }
+
+    // --- Corpus ---
+    // The bench suite plus up to `extraPerPosition` positions reached by random plies from each
+    std::vector<GameState> buildCorpus(int extraPerPosition) {
+        std::vector<GameState> corpus;
+        std::mt19937_64 rng(12345);
+        for (int i = 0; i < Bench::suiteSize(); ++i) {
+            GameState state;
+            if (!state.fromNotation(Bench::suitePosition(i))) continue;
+            corpus.push_back(state);
+            for (int extra = 0; extra < extraPerPosition; ++extra) {
+                std::vector<Move> moves = state.getAllLegalMoves(state.getCurrentPlayer());
+                if (moves.empty()) break;
+                GameState next = state;
+                next.applyMove(moves[rng() % moves.size()]);
+                if (next.checkWinner() != Player::NONE) break;
+                next.switchPlayer();
+                state = next;
+                corpus.push_back(state);
+            }
+        }
+        return corpus;
+    }
+
+} // namespace
+
+
+int main(int argc, char* argv[]) {
+    const char* progName = (argc > 0 && argv[0] != nullptr) ? argv[0] : "jungle_bench";
+    std::string usage = std::string("Usage: ") + progName + " [--min-time MS] [--filter NAME] [--book FILE] [--search-depth N] [--batch-threads N]";
+    BenchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) { std::cout << usage << std::endl; return 0; }
+        bool hasValue = (i + 1 < argc);
+        try {
+            if (strcmp(argv[i], "--min-time") == 0 && hasValue) options.minTimeMs = std::max(1, std::stoi(argv[++i]));
+            else if (strcmp(argv[i], "--filter") == 0 && hasValue) options.filter = argv[++i];
+            else if (strcmp(argv[i], "--book") == 0 && hasValue) options.bookFile = argv[++i];
+            else if (strcmp(argv[i], "--search-depth") == 0 && hasValue) options.searchDepth = std::max(0, std::stoi(argv[++i]));
+            else if (strcmp(argv[i], "--batch-threads") == 0 && hasValue) options.batchThreads = static_cast<unsigned>(std::max(2, std::stoi(argv[++i])));
+            else { std::cerr << "Error: Unknown or incomplete argument '" << argv[i] << "'." << std::endl << usage << std::endl; return 1; }
+        } catch (const std::exception&) {
+            std::cerr << "Error: Invalid value for " << argv[i - 1] << ": '" << argv[i] << "'" << std::endl; return 1;
+        }
+    }
+
+    // --- Inputs (built before any timing) ---
+    std::vector<GameState> corpus = buildCorpus(8);
+    std::vector<std::pair<size_t, Move>> candidateMoves; // Every orthogonal step and L/T jump target, legal or not
+    std::vector<std::pair<size_t, Move>> legalMoves;
+    for (size_t p = 0; p < corpus.size(); ++p) {
+        const GameState& state = corpus[p];
+        for (const Move& move : state.getAllLegalMoves(state.getCurrentPlayer())) legalMoves.push_back({p, move});
+        for (int r = 0; r < BOARD_ROWS; ++r) {
+            for (int c = 0; c < BOARD_COLS; ++c) {
+                if (state.getPiece(r, c).owner != state.getCurrentPlayer()) continue;
+                const int steps[8][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {4, 0}, {-4, 0}, {0, 3}, {0, -3}};
+                for (const auto& step : steps) {
+                    int toRow = r + step[0], toCol = c + step[1];
+                    if (toRow < 0 || toRow >= BOARD_ROWS || toCol < 0 || toCol >= BOARD_COLS) continue;
+                    candidateMoves.push_back({p, Move{r, c, toRow, toCol}});
+                }
+            }
+        }
+    }
+    std::cout << "Corpus: " << corpus.size() << " positions, " << legalMoves.size() << " legal moves, "
+              << candidateMoves.size() << " candidate moves" << std::endl;
+
+    CycleCounter cycles;
+    if (!cycles.available()) std::cout << "(CPU cycle counter not available: perf_event_open failed)" << std::endl;
+
+    // --- Board Primitives ---
+    measure("getAllLegalMoves", corpus.size(), [&]() {
+        uint64_t total = 0;
+        for (const GameState& state : corpus) total += state.getAllLegalMoves(state.getCurrentPlayer()).size();
+        sink = sink + total;
+    }, options, cycles);
+
+    measure("isMoveLegal", candidateMoves.size(), [&]() {
+        uint64_t total = 0;
+        for (const auto& [p, move] : candidateMoves) total += corpus[p].isMoveLegal(move, corpus[p].getCurrentPlayer());
+        sink = sink + total;
+    }, options, cycles);
+
+    measure("applyMove (copy-make)", legalMoves.size(), [&]() {
+        uint64_t total = 0;
+        for (const auto& [p, move] : legalMoves) {
+            GameState next = corpus[p];
+            next.applyMove(move);
+            next.switchPlayer();
+            total += next.getHashKey();
+        }
+        sink = sink + total;
+    }, options, cycles);
+
+    measure("getHashKey", corpus.size(), [&]() {
+        uint64_t total = 0;
+        for (const GameState& state : corpus) total ^= state.getHashKey();
+        sink = sink + total;
+    }, options, cycles);
+
+    std::vector<GameState> scratch = corpus;
+    measure("recalculateHash", scratch.size(), [&]() {
+        uint64_t total = 0;
+        for (GameState& state : scratch) { state.recalculateHash(); total ^= state.getHashKey(); }
+        sink = sink + total;
+    }, options, cycles);
+
+    measure("evaluateBoard", corpus.size(), [&]() {
+        int64_t total = 0;
+        for (const GameState& state : corpus) total += Evaluation::evaluateBoard(state);
+        sink = sink + static_cast<uint64_t>(total);
+    }, options, cycles);
+
+    // --- Evaluation Terms (what evaluateBoard spends its time on; both sides per op) ---
+    measure("eval: material+PST", corpus.size(), [&]() {
+        int64_t total = 0;
+        for (const GameState& state : corpus) total += Evaluation::evaluateMaterialPst(state);
+        sink = sink + static_cast<uint64_t>(total);
+    }, options, cycles);
+
+    measure("eval: positional terms", corpus.size(), [&]() {
+        int64_t total = 0;
+        for (const GameState& state : corpus) total += Evaluation::evaluatePositionalTerms(state);
+        sink = sink + static_cast<uint64_t>(total);
+    }, options, cycles);
+
+    measure("eval: rat/elephant tables", corpus.size(), [&]() {
+        int64_t total = 0;
+        for (const GameState& state : corpus) {
+            total += Evaluation::elephantTrapRisk<Player::PLAYER1>(state) - Evaluation::elephantTrapRisk<Player::PLAYER2>(state);
+            total += Evaluation::ratInterceptScore<Player::PLAYER2>(state) - Evaluation::ratInterceptScore<Player::PLAYER1>(state);
+        }
+        sink = sink + static_cast<uint64_t>(total);
+    }, options, cycles);
+
+    measure("eval: mobility/threats", corpus.size(), [&]() {
+        int64_t total = 0;
+        for (const GameState& state : corpus) {
+            Evaluation::SideActivity ai = Evaluation::computeSideActivity<Player::PLAYER2>(state);
+            Evaluation::SideActivity human = Evaluation::computeSideActivity<Player::PLAYER1>(state);
+            total += ai.mobility - human.mobility + ai.threatenedValue - human.threatenedValue;
+        }
+        sink = sink + static_cast<uint64_t>(total);
+    }, options, cycles);
+
+    // --- Batch Evaluation (see Evaluation::evaluateBatch / computeBoardTerms) ---
+    // The corpus repeated up to --batch-threads full chunks, so evaluateBatch really splits it;
+    // a plain evaluateBoard loop and a 1-thread batch over the same positions are the baselines.
+    std::string batchThreadsName = "evaluateBatch (" + std::to_string(options.batchThreads) + " threads)";
+    bool runBatch = false;
+    for (const std::string& name : {std::string("evaluate loop (batch)"), std::string("evaluateBatch (1 thread)"), batchThreadsName}) {
+        runBatch = runBatch || options.filter.empty() || name.find(options.filter) != std::string::npos;
+    }
+    std::vector<GameState> batchCorpus;
+    if (runBatch && !corpus.empty()) {
+        size_t batchSize = options.batchThreads * Evaluation::BATCH_MIN_POSITIONS_PER_THREAD;
+        batchCorpus.reserve(batchSize);
+        for (size_t i = 0; i < batchSize; ++i) batchCorpus.push_back(corpus[i % corpus.size()]);
+        std::cout << "Batch corpus: " << batchCorpus.size() << " positions" << std::endl;
+    }
+    std::vector<int> batchScores(batchCorpus.size());
+    measure("evaluate loop (batch)", batchCorpus.size(), [&]() {
+        for (size_t i = 0; i < batchCorpus.size(); ++i) batchScores[i] = Evaluation::evaluateBoard(batchCorpus[i]);
+        sink = sink + static_cast<uint64_t>(batchScores.back());
+    }, options, cycles);
+    measure("evaluateBatch (1 thread)", batchCorpus.size(), [&]() {
+        Evaluation::evaluateBatch(batchCorpus.data(), batchCorpus.size(), batchScores.data(), 1);
+        sink = sink + static_cast<uint64_t>(batchScores.back());
+    }, options, cycles);
+    measure(batchThreadsName.c_str(), batchCorpus.size(), [&]() {
+        Evaluation::evaluateBatch(batchCorpus.data(), batchCorpus.size(), batchScores.data(), options.batchThreads);
+        sink = sink + static_cast<uint64_t>(batchScores.back());
+    }, options, cycles);
+
+    // Full rebuild of the material/PST and den terms (GameState::recalculateEvalTerms) per kernel
+    std::vector<Evaluation::BoardPlanes> planes(corpus.size());
+    for (size_t p = 0; p < corpus.size(); ++p) Evaluation::fillBoardPlanes(corpus[p].getBoard(), planes[p]);
+    measure("boardTerms batch (scalar)", planes.size(), [&]() {
+        int64_t total = 0;
+        for (const Evaluation::BoardPlanes& plane : planes) total += Evaluation::computeBoardTermsScalar(plane).materialPst[1];
+        sink = sink + static_cast<uint64_t>(total);
+    }, options, cycles);
+    Evaluation::BoardTerms probeTerms;
+    bool haveAVX2 = !planes.empty() && Evaluation::computeBoardTermsAVX2(planes[0], probeTerms);
+    if (!haveAVX2) std::cout << "(No AVX2 kernel in this build or CPU, skipping boardTerms batch (AVX2))" << std::endl;
+    measure("boardTerms batch (AVX2)", haveAVX2 ? planes.size() : 0, [&]() {
+        int64_t total = 0;
+        Evaluation::BoardTerms terms;
+        for (const Evaluation::BoardPlanes& plane : planes) { Evaluation::computeBoardTermsAVX2(plane, terms); total += terms.materialPst[1]; }
+        sink = sink + static_cast<uint64_t>(total);
+    }, options, cycles);
+
+    // --- Search ---
+    // Iterative deepening to --search-depth on each bench suite position with a fresh 1 MB engine
+    // (as Bench::run does, engine setup included). One op is one search node, so ns/op tracks the
+    // cost of the search code itself (move ordering, the side-templated alphaBeta, TT, leaf eval).
+    const size_t SEARCH_HASH_MB = 1;
+    std::vector<GameState> suite;
+    for (int i = 0; i < Bench::suiteSize(); ++i) {
+        GameState state;
+        if (state.fromNotation(Bench::suitePosition(i))) suite.push_back(state);
+    }
+    auto searchSuite = [&]() {
+        uint64_t nodes = 0;
+        for (const GameState& state : suite) {
+            Engine engine(SEARCH_HASH_MB);
+#ifdef USE_TRANSPOSITION_TABLE
+            engine.setPersistentTT(true); // Iterations share the TT
+#endif
+            for (int depth = 1; depth <= options.searchDepth; ++depth) {
+                AIMoveInfo info = engine.getBestMove(state, depth, false, true);
+                nodes += info.nodesSearched;
+                if (info.bestMove.fromRow == -1) break;
+            }
+        }
+        return nodes;
+    };
+    std::string searchName = "search depth " + std::to_string(options.searchDepth) + " (per node)";
+    bool runSearch = options.filter.empty() || searchName.find(options.filter) != std::string::npos;
+    if (options.searchDepth > 0 && runSearch) {
+        measure(searchName.c_str(), searchSuite(), [&]() {
+            sink = sink + searchSuite();
+        }, options, cycles);
+    }
+
+    // --- Opening Book ---
+    // Every prefix of every variation (hits) plus each prefix with one off-book move appended (misses)
+    Book::OpeningBook book;
+    std::vector<std::vector<Move>> bookSequences;
+    if (book.load(options.bookFile)) {
+        for (const std::vector<Move>& variation : book.getVariations()) {
+            for (size_t length = 0; length <= variation.size(); ++length) {
+                std::vector<Move> prefix(variation.begin(), variation.begin() + length);
+                bookSequences.push_back(prefix);
+                prefix.push_back(Move{4, 0, 4, 1});
+                bookSequences.push_back(prefix);
+            }
+        }
+    } else {
+        std::cout << "(No opening book at " << options.bookFile << ", skipping Book::findBookMove)" << std::endl;
+    }
+    measure("Book::findBookMove", bookSequences.size(), [&]() {
+        uint64_t total = 0;
+        for (const std::vector<Move>& sequence : bookSequences) total += static_cast<uint64_t>(book.findBookMove(sequence).fromRow + 1);
+        sink = sink + total;
+    }, options, cycles);
+
+#ifdef USE_TRANSPOSITION_TABLE
+    // --- Transposition Table (default size; keys of every child position in the corpus) ---
+    Engine engine;
+    std::vector<uint64_t> ttKeys;
+    for (const auto& [p, move] : legalMoves) ttKeys.push_back(corpus[p].getHashKeyAfterMove(move));
+    std::mt19937_64 keyRng(777);
+    std::shuffle(ttKeys.begin(), ttKeys.end(), keyRng); // Search order doesn't walk the table sequentially either
+    int ttDepth = 0;
+    measure("TT store", ttKeys.size(), [&]() {
+        ++ttDepth; // Deeper each pass, so the replacement rule keeps accepting
+        for (uint64_t key : ttKeys) engine.storeTT(key, ttDepth, static_cast<int>(key & 0xFFFF), TTBound::EXACT, Move{0, 0, 1, 0});
+    }, options, cycles);
+
+    measure("TT probe (hit)", ttKeys.size(), [&]() {
+        uint64_t total = 0;
+        for (uint64_t key : ttKeys) { const TTEntry* entry = engine.probeTT(key); total += entry ? static_cast<uint64_t>(entry->score) : 0; }
+        sink = sink + total;
+    }, options, cycles);
+
+    std::vector<uint64_t> missKeys(ttKeys.size());
+    for (uint64_t& key : missKeys) key = keyRng();
+    measure("TT probe (miss)", missKeys.size(), [&]() {
+        uint64_t total = 0;
+        for (uint64_t key : missKeys) total += engine.probeTT(key) != nullptr;
+        sink = sink + total;
+    }, options, cycles);
+#endif // USE_TRANSPOSITION_TABLE
+
+    return 0;
+}
@@ -0,0 +1,145 @@
+#include "NNUE.h"
+#include "GameState.h"
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <cstring>   // For std::memcmp
+
+// AVX2 output layer is compiled with a per-function target attribute and selected
+// at runtime (same scheme as the SoA kernel in Evaluation.cpp).
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define NNUE_HAVE_AVX2
+#endif
+
+namespace NNUE {
+
+    bool active = false;
+    uint32_t network = 0;
+
+    // --- Network Parameters ---
+    namespace {
+        const char FILE_MAGIC[8] = {'J','C','N','N','U','E','0','1'};
+        const uint32_t FILE_VERSION = 1;
+
+        int32_t outputScale = 0;
+        alignas(32) int16_t featureBias[HIDDEN_SIZE];
+        std::vector<int16_t> featureWeights; // [INPUT_SIZE][HIDDEN_SIZE]
+        alignas(32) int8_t outputWeights[HIDDEN_SIZE];
+        int32_t outputBias = 0;
+
+        template <typename T>
+        bool readArray(std::ifstream& in, T* data, size_t count) {
+            in.read(reinterpret_cast<char*>(data), count * sizeof(T));
+            return !in.fail();
+        }
+    }
+
+    bool load(const std::string& filename) {
+        std::ifstream inFile(filename, std::ios::binary);
+        if (!inFile.is_open()) { std::cerr << "Error opening NNUE weights file: " << filename << std::endl; return false; }
+
+        char magic[8]; uint32_t version = 0, inputSize = 0, hiddenSize = 0; int32_t scale = 0;
+        inFile.read(magic, sizeof(magic));
+        readArray(inFile, &version, 1); readArray(inFile, &inputSize, 1); readArray(inFile, &hiddenSize, 1); readArray(inFile, &scale, 1);
+        if (inFile.fail() || std::memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0 || version != FILE_VERSION) {
+            std::cerr << "Error: '" << filename << "' is not a supported NNUE weights file." << std::endl; return false;
+        }
+        if (inputSize != INPUT_SIZE || hiddenSize != HIDDEN_SIZE) {
+            std::cerr << "Error: NNUE network shape " << inputSize << "x" << hiddenSize << " does not match this build ("
+                      << INPUT_SIZE << "x" << HIDDEN_SIZE << ")." << std::endl;
+            return false;
+        }
+
+        std::vector<int16_t> weights(static_cast<size_t>(INPUT_SIZE) * HIDDEN_SIZE);
+        int16_t bias[HIDDEN_SIZE]; int8_t outWeights[HIDDEN_SIZE]; int32_t outBias = 0;
+        if (!readArray(inFile, bias, HIDDEN_SIZE) || !readArray(inFile, weights.data(), weights.size()) ||
+            !readArray(inFile, outWeights, HIDDEN_SIZE) || !readArray(inFile, &outBias, 1)) {
+            std::cerr << "Error: NNUE weights file '" << filename << "' is truncated." << std::endl; return false;
+        }
+
+        // Only commit once everything is read
+        std::memcpy(featureBias, bias, sizeof(featureBias));
+        featureWeights.swap(weights);
+        std::memcpy(outputWeights, outWeights, sizeof(outputWeights));
+        outputBias = outBias;
+        outputScale = scale;
+        active = true;
+        ++network; // Accumulators built for the previous network are stale now
+        return true;
+    }
+
+    void resetAccumulator(int16_t* accumulator) {
+        std::memcpy(accumulator, featureBias, sizeof(featureBias));
+    }
+
+    // Plain loop: the compiler vectorizes this to full-width int16 adds
+    void updateAccumulator(int16_t* accumulator, int feature, int sign) {
+        const int16_t* row = &featureWeights[static_cast<size_t>(feature) * HIDDEN_SIZE];
+        if (sign > 0) { for (int i = 0; i < HIDDEN_SIZE; ++i) accumulator[i] += row[i]; }
+        else          { for (int i = 0; i < HIDDEN_SIZE; ++i) accumulator[i] -= row[i]; }
+    }
+
+    void buildAccumulator(const GameState& gameState, int16_t* accumulator) {
+        resetAccumulator(accumulator);
+        const std::vector<std::vector<Piece>>& board = gameState.getBoard();
+        for (int r = 0; r < BOARD_ROWS; ++r) {
+            for (int c = 0; c < BOARD_COLS; ++c) {
+                const Piece& piece = board[r][c];
+                if (piece.type == PieceType::EMPTY || piece.owner == Player::NONE) continue;
+                int sq = r * BOARD_COLS + c;
+                updateAccumulator(accumulator, pieceFeature(piece.type, piece.owner, sq), +1);
+                if (piece.weakened) updateAccumulator(accumulator, weakenedFeature(piece.owner, sq), +1);
+            }
+        }
+    }
+
+    // --- Output Layer ---
+    static int32_t outputLayerScalar(const int16_t* accumulator) {
+        int32_t sum = outputBias;
+        for (int i = 0; i < HIDDEN_SIZE; ++i) {
+            int hidden = accumulator[i] < 0 ? 0 : (accumulator[i] > CLIPPED_RELU_MAX ? CLIPPED_RELU_MAX : accumulator[i]);
+            sum += hidden * outputWeights[i];
+        }
+        return sum;
+    }
+
+#ifdef NNUE_HAVE_AVX2
+    // Clip 32 accumulator lanes to [0, 127] as unsigned bytes, then maddubs against the int8 weights
+    __attribute__((target("avx2")))
+    static int32_t outputLayerAVX2(const int16_t* accumulator) {
+        const __m256i ones = _mm256_set1_epi16(1);
+        const __m256i reluMax = _mm256_set1_epi8(CLIPPED_RELU_MAX);
+        __m256i sum = _mm256_setzero_si256();
+        for (int i = 0; i < HIDDEN_SIZE; i += 32) {
+            __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(accumulator + i));
+            __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(accumulator + i + 16));
+            // packus saturates to [0, 255] and interleaves 128-bit lanes; permute restores order
+            __m256i hidden = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+            hidden = _mm256_min_epu8(hidden, reluMax);
+            __m256i weights = _mm256_load_si256(reinterpret_cast<const __m256i*>(outputWeights + i));
+            __m256i products = _mm256_maddubs_epi16(hidden, weights); // |127 * 128 * 2| fits int16
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(products, ones));
+        }
+        __m128i sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(1, 0, 3, 2)));
+        sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(2, 3, 0, 1)));
+        return outputBias + _mm_cvtsi128_si32(sum128);
+    }
+#endif // NNUE_HAVE_AVX2
+
+    int evaluate(const GameState& gameState) {
+        const Accumulator& stored = gameState.getNnueAccumulator();
+        alignas(32) int16_t rebuilt[HIDDEN_SIZE];
+        const int16_t* accumulator = stored.values.data();
+        if (!stored.isCurrent()) { buildAccumulator(gameState, rebuilt); accumulator = rebuilt; } // State from before load()
+#ifdef NNUE_HAVE_AVX2
+        static const bool useAVX2 = __builtin_cpu_supports("avx2");
+        int32_t output = useAVX2 ? outputLayerAVX2(accumulator) : outputLayerScalar(accumulator);
+#else
+        int32_t output = outputLayerScalar(accumulator);
+#endif
+        return static_cast<int>((static_cast<int64_t>(output) * outputScale) / 1024);
+    }
+
+} // namespace NNUE
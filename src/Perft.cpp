@@ -0,0 +1,167 @@
+// Move generation perft (build target: perft)
+//
+// Counts the leaves of the legal-move tree to a fixed depth from any position, using the same
+// getAllLegalMoves() + applyMove() + switchPlayer() sequence as the search. A den entry ends
+// the game (the position after it has no moves), as does a side without legal moves.
+// Subtree counts are cached in a shared hash table keyed by position and depth, and the
+// root moves are split across threads. Prints leaves, time, leaves/s and generated moves/s,
+// so it doubles as a move generator benchmark (use --hash 0 for the raw generator speed).
+
+#include "GameState.h"
+#include "Book.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <cstring>   // For strcmp
+#include <stdexcept> // For std::stoi exceptions
+#include <algorithm>
+
+namespace {
+
+    // --- Subtree Count Cache ---
+    // Lockless (Hyatt/Mann XOR trick): an entry is { key ^ data, data } with data = count << 8 | depth,
+    // so a slot torn by two threads writing at once fails the check instead of returning a wrong count.
+    class PerftTable {
+    public:
+        explicit PerftTable(size_t sizeMB) {
+            size_t maxEntries = (sizeMB * 1024 * 1024) / sizeof(Entry);
+            if (maxEntries == 0) return;
+            size_t entries = 1;
+            while (entries * 2 <= maxEntries) entries *= 2;
+            table = std::make_unique<Entry[]>(entries);
+            mask = entries - 1;
+        }
+
+        bool enabled() const { return table != nullptr; }
+
+        bool probe(uint64_t key, int depth, uint64_t& count) const {
+            const Entry& entry = table[slot(key, depth)];
+            uint64_t data = entry.data.load(std::memory_order_relaxed);
+            if ((entry.keyXorData.load(std::memory_order_relaxed) ^ data) != key || static_cast<int>(data & 0xFF) != depth) return false;
+            count = data >> 8;
+            return true;
+        }
+
+        void store(uint64_t key, int depth, uint64_t count) {
+            Entry& entry = table[slot(key, depth)];
+            uint64_t data = (count << 8) | static_cast<uint64_t>(depth);
+            entry.keyXorData.store(key ^ data, std::memory_order_relaxed);
+            entry.data.store(data, std::memory_order_relaxed);
+        }
+
+    private:
+        struct Entry {
+            std::atomic<uint64_t> keyXorData{0};
+            std::atomic<uint64_t> data{0};
+        };
+        std::unique_ptr<Entry[]> table;
+        size_t mask = 0;
+
+        // Depth is mixed into the index so one position's counts at different depths don't evict each other
+        size_t slot(uint64_t key, int depth) const { return (key ^ (static_cast<uint64_t>(depth) * 0x9E3779B97F4A7C15ULL)) & mask; }
+    };
+
+    struct PerftCounters {
+        uint64_t generatedMoves = 0; // Moves returned by getAllLegalMoves (the throughput figure)
+    };
+
+    // Leaves at `depth` below state (side to move = state.getCurrentPlayer()). Depth 1 is bulk-counted.
+    uint64_t perft(const GameState& state, int depth, PerftTable& table, PerftCounters& counters) {
+        if (depth == 0) return 1;
+        if (state.checkWinner() != Player::NONE) return 0; // Game over: no moves
+        uint64_t cached = 0;
+        // The weakened flag changes what can be captured, so it has to be part of the key
+        uint64_t key = (depth > 1 && table.enabled()) ? state.getHashKeyWithWeakened() : 0;
+        if (depth > 1 && table.enabled() && table.probe(key, depth, cached)) return cached;
+
+        std::vector<Move> moves = state.getAllLegalMoves(state.getCurrentPlayer());
+        counters.generatedMoves += moves.size();
+        if (depth == 1) return moves.size();
+
+        uint64_t leaves = 0;
+        for (const Move& move : moves) {
+            GameState next = state;
+            next.applyMove(move);
+            next.switchPlayer();
+            leaves += perft(next, depth - 1, table, counters);
+        }
+        if (table.enabled()) table.store(key, depth, leaves);
+        return leaves;
+    }
+
+} // namespace
+
+
+int main(int argc, char* argv[]) {
+    const char* progName = (argc > 0 && argv[0] != nullptr) ? argv[0] : "perft";
+    std::string usage = std::string("Usage: ") + progName +
+        " [--depth N] [--fen <notation> <side>] [--divide] [--threads N] [--hash MB]";
+    int depth = 5;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t hashMB = 64; // 0 = no subtree cache
+    bool divide = false;
+    GameState root;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) { std::cout << usage << std::endl; return 0; }
+        bool hasValue = (i + 1 < argc);
+        try {
+            if (strcmp(argv[i], "--depth") == 0 && hasValue) depth = std::stoi(argv[++i]);
+            else if (strcmp(argv[i], "--threads") == 0 && hasValue) threads = std::max(1, std::stoi(argv[++i]));
+            else if (strcmp(argv[i], "--hash") == 0 && hasValue) hashMB = std::stoull(argv[++i]);
+            else if (strcmp(argv[i], "--divide") == 0) divide = true;
+            else if (strcmp(argv[i], "--fen") == 0 && i + 2 < argc) {
+                std::string notation = std::string(argv[i + 1]) + " " + argv[i + 2];
+                i += 2;
+                if (!root.fromNotation(notation.c_str())) { std::cerr << "Error: Invalid position '" << notation << "'." << std::endl; return 1; }
+            }
+            else { std::cerr << "Error: Unknown or incomplete argument '" << argv[i] << "'." << std::endl << usage << std::endl; return 1; }
+        } catch (const std::exception&) {
+            std::cerr << "Error: Invalid value for " << argv[i - 1] << ": '" << argv[i] << "'" << std::endl; return 1;
+        }
+    }
+    if (depth < 1 || depth > 255) { std::cerr << "Error: --depth must be between 1 and 255." << std::endl; return 1; }
+
+    PerftTable table(hashMB);
+    std::vector<Move> rootMoves;
+    if (root.checkWinner() == Player::NONE) rootMoves = root.getAllLegalMoves(root.getCurrentPlayer());
+    std::vector<uint64_t> rootCounts(rootMoves.size(), 0);
+    std::vector<PerftCounters> counters(std::max(1, std::min<int>(threads, static_cast<int>(rootMoves.size()))));
+    std::cout << "Perft " << root.toNotation() << " depth " << depth << ", " << counters.size() << " threads, hash "
+              << (table.enabled() ? std::to_string(hashMB) + " MB" : std::string("off")) << std::endl;
+
+    // --- Root Split: threads take root moves one at a time ---
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<size_t> nextMove{0};
+    auto runWorker = [&](int t) {
+        for (size_t i = nextMove++; i < rootMoves.size(); i = nextMove++) {
+            GameState next = root;
+            next.applyMove(rootMoves[i]);
+            next.switchPlayer();
+            rootCounts[i] = perft(next, depth - 1, table, counters[t]);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (int t = 1; t < static_cast<int>(counters.size()); ++t) workers.emplace_back(runWorker, t);
+    runWorker(0);
+    for (std::thread& worker : workers) worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    uint64_t leaves = 0, generated = rootMoves.size();
+    for (size_t i = 0; i < rootMoves.size(); ++i) {
+        leaves += rootCounts[i];
+        if (divide) std::cout << Book::moveToAlgebraic(rootMoves[i]) << ": " << rootCounts[i] << std::endl;
+    }
+    for (const PerftCounters& c : counters) generated += c.generatedMoves;
+
+    double safeSeconds = std::max(seconds, 1e-9);
+    std::cout << "Root moves: " << rootMoves.size() << std::endl;
+    std::cout << "Leaves    : " << leaves << std::endl;
+    std::cout << "Time (ms) : " << static_cast<int64_t>(seconds * 1000.0) << std::endl;
+    std::cout << "Leaves/s  : " << static_cast<uint64_t>(leaves / safeSeconds) << std::endl;
+    std::cout << "Moves/s   : " << static_cast<uint64_t>(generated / safeSeconds) << " (" << generated << " generated)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,375 @@
+// Self-play match runner with SPRT (build target: selfplay)
+//
+// Plays engine configuration A against B: game pairs from the same opening with colors swapped,
+// each pair played by one of the worker threads. Each worker owns two Engine instances (A and B, each with its own
+// TT), so the players never share search state. Openings come from a position file, the opening
+// book or random plies.
+// Each game is written as one line to the games file:
+//   <A's color> | <start position notation> | <moves> | <result: 1-0 Player 1 won, 0-1, 1/2-1/2>
+// After every pair it updates W/D/L, Elo +/- 95% and the SPRT log-likelihood ratio, and stops
+// early once H0 (elo0) or H1 (elo1) is accepted. The statistics are pentanomial: a pair (A's
+// score 0, 1/2, 1, 3/2 or 2) is one trial, because the two games of a pair share an opening and
+// are correlated; counting them as independent games underestimates the variance. With --stats-json, every engine move also
+// writes one JSON line of search statistics (summed over its iterations).
+
+#include "GameState.h"
+#include "AI.h"
+#include "Evaluation.h"
+#include "Book.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <chrono>
+#include <cstring>   // For strcmp
+#include <stdexcept> // For std::stoi exceptions
+#include <iomanip>   // For std::setprecision
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <memory>
+
+namespace {
+
+    // --- Engine Configurations ---
+    struct EngineConfig {
+        SearchParams params = DEFAULT_SEARCH_PARAMS;
+        uint64_t nodes = 0;     // Per move, 0 = no limit
+        int64_t moveTimeMs = 0; // Per move, 0 = no limit
+        int depth = 0;          // 0 = no limit (one of the three must be set)
+        std::string name;       // "A" or "B" (stats lines)
+    };
+
+    // "key=value,key=value": nodes, movetime, depth or a SearchParams field name
+    bool parseEngineConfig(const std::string& text, EngineConfig& config) {
+        std::istringstream in(text);
+        std::string item;
+        while (std::getline(in, item, ',')) {
+            size_t eq = item.find('=');
+            if (eq == std::string::npos) return false;
+            std::string key = item.substr(0, eq), value = item.substr(eq + 1);
+            try {
+                if (key == "nodes") config.nodes = std::stoull(value);
+                else if (key == "movetime") config.moveTimeMs = std::stoll(value);
+                else if (key == "depth") config.depth = std::stoi(value);
+                else {
+                    bool found = false;
+                    for (const SearchParamField& field : SEARCH_PARAM_FIELDS) {
+                        if (key == field.name) { config.params.*(field.field) = std::stoi(value); found = true; }
+                    }
+                    if (!found) return false;
+                }
+            } catch (const std::exception&) { return false; }
+        }
+        return true;
+    }
+
+    struct MatchOptions {
+        int games = 100;          // Rounded up to whole pairs
+        int workers = 1;
+        int maxPlies = 300;       // Then adjudicated as a draw
+        int randomPlies = 6;      // Random openings: plies before the engines take over
+        int bookPlies = 8;        // Book openings: plies taken from a random variation
+        size_t hashMB = 16;       // Per engine (two per worker)
+        uint64_t seed = 1;
+        std::string openingsFile; // Position notation per line
+        std::string bookFile;     // Opening book variations
+        std::string gamesFile = "selfplay.games";
+        std::string statsFile;    // --stats-json: empty = off
+        double elo0 = 0.0, elo1 = 5.0, alpha = 0.05, beta = 0.05;
+    };
+
+    // --- Openings ---
+    // Deterministic per pair: both games of a pair (and reruns with the same seed) start alike
+    GameState makeOpening(int pairIndex, const MatchOptions& options, const std::vector<GameState>& openingList) {
+        if (!openingList.empty()) return openingList[pairIndex % openingList.size()];
+        GameState state;
+        std::mt19937_64 rng(options.seed * 1000003ULL + pairIndex);
+        std::vector<Move> line;
+        const auto& variations = Book::getVariations();
+        if (!variations.empty()) {
+            const std::vector<Move>& variation = variations[rng() % variations.size()];
+            line.assign(variation.begin(), variation.begin() + std::min<size_t>(variation.size(), options.bookPlies));
+        }
+        int plies = line.empty() ? options.randomPlies : static_cast<int>(line.size());
+        for (int ply = 0; ply < plies; ++ply) {
+            std::vector<Move> moves = state.getAllLegalMoves(state.getCurrentPlayer());
+            if (moves.empty()) break;
+            Move move = line.empty() ? moves[rng() % moves.size()] : line[ply];
+            GameState next = state; next.applyMove(move);
+            if (next.checkWinner() != Player::NONE || !state.isMoveLegal(move, state.getCurrentPlayer())) break; // Keep openings undecided
+            state = next; state.switchPlayer();
+        }
+        return state;
+    }
+
+    // --- Games ---
+    // Iterative deepening under the config's limits; an aborted iteration only counts if none completed.
+    // moveStats sums the statistics of all iterations, completedDepth is the last full iteration.
+    // Returns fromRow == -1 if the engine was stopped (match decided).
+    Move chooseMove(Engine& engine, const GameState& state, const EngineConfig& config, SearchStats& moveStats, int& completedDepth) {
+        auto start = std::chrono::steady_clock::now();
+        engine.setSearchParams(config.params);
+        Move best = {-1,-1,-1,-1};
+        uint64_t totalNodes = 0;
+        int maxDepth = (config.depth > 0) ? config.depth : 64;
+        for (int depth = 1; depth <= maxDepth; ++depth) {
+            int64_t elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+            int64_t timeLeft = (config.moveTimeMs > 0) ? std::max<int64_t>(1, config.moveTimeMs - elapsedMs) : 0;
+            uint64_t nodesLeft = (config.nodes > 0) ? std::max<uint64_t>(1, config.nodes - std::min(config.nodes, totalNodes)) : 0;
+            engine.setSearchLimits(nodesLeft, timeLeft);
+            AIMoveInfo info = engine.getBestMove(state, depth, false, true);
+            if (info.aborted && engine.isStopRequested()) return {-1,-1,-1,-1}; // Not a limit: the search still returns a move
+            totalNodes += info.nodesSearched;
+            moveStats.add(info.stats);
+            if (info.bestMove.fromRow == -1) break;
+            if (info.aborted) { if (best.fromRow == -1) best = info.bestMove; break; }
+            best = info.bestMove;
+            completedDepth = depth;
+            if (Evaluation::isWinScore(info.finalScore)) break; // Forced result
+            if (config.nodes > 0 && totalNodes >= config.nodes) break;
+        }
+        return best;
+    }
+
+    // Plays one game; returns the record line (without A's color) and the result from Player 1's view (1, 0.5, 0)
+    // Engines are (engine, config) per player. A stopped engine (match decided) ends the game without
+    // a result: the returned record is empty.
+    // statsLines (if not null) receives one JSON line per move, prefixed by statsPrefix.
+    std::string playGame(GameState state, Engine& engine1, const EngineConfig& player1, Engine& engine2, const EngineConfig& player2,
+                         int maxPlies, double& player1Score, std::vector<std::string>* statsLines, const std::string& statsPrefix) {
+        std::string record = state.toNotation() + " |";
+        player1Score = 0.5;
+        for (int ply = 0; ply < maxPlies; ++ply) {
+            Player toMove = state.getCurrentPlayer();
+            if (state.getAllLegalMoves(toMove).empty()) { player1Score = (toMove == Player::PLAYER1) ? 0.0 : 1.0; break; }
+            const EngineConfig& config = (toMove == Player::PLAYER1) ? player1 : player2;
+            SearchStats moveStats;
+            int completedDepth = 0;
+            Move move = chooseMove(toMove == Player::PLAYER1 ? engine1 : engine2, state, config, moveStats, completedDepth);
+            if (move.fromRow == -1) return std::string(); // Stopped (there are legal moves)
+            if (statsLines) {
+                statsLines->push_back(statsPrefix + "\"ply\":" + std::to_string(ply) + ",\"engine\":\"" + config.name + "\",\"depth\":"
+                                      + std::to_string(completedDepth) + ",\"move\":\"" + Book::moveToAlgebraic(move) + "\",\"stats\":" + moveStats.toJson() + "}");
+            }
+            record += " " + Book::moveToAlgebraic(move);
+            state.applyMove(move);
+            Player winner = state.checkWinner();
+            if (winner != Player::NONE) { player1Score = (winner == Player::PLAYER1) ? 1.0 : 0.0; break; }
+            state.switchPlayer();
+        }
+        record += (player1Score == 1.0) ? " | 1-0" : (player1Score == 0.0) ? " | 0-1" : " | 1/2-1/2";
+        return record;
+    }
+
+    // Game j: pair j / 2; A plays Player 1 in even games. Result line: "<j> <A's score x2> <record>",
+    // empty if the game was stopped
+    std::string playMatchGame(int gameIndex, Engine& engineA, const EngineConfig& a, Engine& engineB, const EngineConfig& b,
+                              const MatchOptions& options, const std::vector<GameState>& openingList, std::vector<std::string>* statsLines) {
+        bool aIsPlayer1 = (gameIndex % 2 == 0);
+        GameState opening = makeOpening(gameIndex / 2, options, openingList);
+#ifdef USE_TRANSPOSITION_TABLE
+        engineA.clearTT(); engineB.clearTT(); // Games don't share TT entries
+#endif
+        double player1Score = 0.5;
+        std::string statsPrefix = "{\"game\":" + std::to_string(gameIndex) + ",";
+        std::string record = aIsPlayer1 ? playGame(opening, engineA, a, engineB, b, options.maxPlies, player1Score, statsLines, statsPrefix)
+                                        : playGame(opening, engineB, b, engineA, a, options.maxPlies, player1Score, statsLines, statsPrefix);
+        if (record.empty()) return record;
+        double aScore = aIsPlayer1 ? player1Score : 1.0 - player1Score;
+        return std::to_string(gameIndex) + " " + std::to_string(static_cast<int>(aScore * 2)) + " "
+             + (aIsPlayer1 ? "A=P1 | " : "A=P2 | ") + record;
+    }
+
+    // --- Statistics ---
+    struct MatchStats {
+        int wins = 0, draws = 0, losses = 0; // Games, from A's view
+        int pairResults[5] = {};             // Pairs by A's score x2 (0 = lost both ... 4 = won both)
+
+        int games() const { return wins + draws + losses; }
+        int pairs() const { return pairResults[0] + pairResults[1] + pairResults[2] + pairResults[3] + pairResults[4]; }
+        void addPair(int aScoreTimes2First, int aScoreTimes2Second) {
+            for (int aScoreTimes2 : {aScoreTimes2First, aScoreTimes2Second}) {
+                if (aScoreTimes2 == 2) wins++; else if (aScoreTimes2 == 1) draws++; else losses++;
+            }
+            pairResults[aScoreTimes2First + aScoreTimes2Second]++;
+        }
+        double score() const { return games() ? (wins + 0.5 * draws) / games() : 0.5; }
+        double variance() const { // Variance of a pair's mean score (k / 4 for pair result k)
+            if (!pairs()) return 0.0;
+            double s = score(), sum = 0.0;
+            for (int k = 0; k < 5; ++k) sum += pairResults[k] * (k / 4.0 - s) * (k / 4.0 - s);
+            return sum / pairs();
+        }
+        static double eloFromScore(double s) {
+            s = std::clamp(s, 1e-6, 1.0 - 1e-6);
+            return 400.0 * std::log10(s / (1.0 - s));
+        }
+        static double scoreFromElo(double elo) { return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0)); }
+        double elo() const { return eloFromScore(score()); }
+        double eloError95() const {
+            if (pairs() < 2) return 0.0;
+            double margin = 1.959964 * std::sqrt(variance() / pairs());
+            return (eloFromScore(score() + margin) - eloFromScore(score() - margin)) / 2.0;
+        }
+        // Generalized SPRT (normal approximation of the pair score): LLR of H1 (elo1) vs H0 (elo0)
+        double llr(double elo0, double elo1) const {
+            double var = variance();
+            if (pairs() < 2 || var <= 0.0) return 0.0;
+            double s0 = scoreFromElo(elo0), s1 = scoreFromElo(elo1);
+            return pairs() * (s1 - s0) * (2.0 * score() - s0 - s1) / (2.0 * var);
+        }
+    };
+
+    void printStats(const MatchStats& stats, const MatchOptions& options, double lower, double upper) {
+        std::cout << "Games " << stats.games() << ": +" << stats.wins << " =" << stats.draws << " -" << stats.losses
+                  << " | Pairs " << stats.pairResults[0] << "/" << stats.pairResults[1] << "/" << stats.pairResults[2]
+                  << "/" << stats.pairResults[3] << "/" << stats.pairResults[4] << std::fixed << std::setprecision(1) << " | Elo " << stats.elo() << " +/- " << stats.eloError95()
+                  << std::setprecision(2) << " | LLR " << stats.llr(options.elo0, options.elo1)
+                  << " [" << lower << ", " << upper << "]" << std::defaultfloat << std::endl;
+    }
+
+} // namespace
+
+
+int main(int argc, char* argv[]) {
+    const char* progName = (argc > 0 && argv[0] != nullptr) ? argv[0] : "selfplay";
+    std::string usage = std::string("Usage: ") + progName +
+        " [--games N] [--workers N] [--nodes N | --movetime MS | --depth N] [--a key=value,...] [--b key=value,...]"
+        " [--openings FILE | --book FILE] [--random-plies N] [--book-plies N] [--max-plies N] [--hash MB]"
+        " [--sprt elo0 elo1] [--alpha X] [--beta X] [--seed N] [--out FILE] [--stats-json FILE]";
+    MatchOptions options;
+    EngineConfig base;
+    std::string configA, configB;
+    options.workers = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) { std::cout << usage << std::endl; return 0; }
+        bool hasValue = (i + 1 < argc);
+        try {
+            if (strcmp(argv[i], "--games") == 0 && hasValue) options.games = std::max(2, std::stoi(argv[++i]));
+            else if (strcmp(argv[i], "--workers") == 0 && hasValue) options.workers = std::max(1, std::stoi(argv[++i]));
+            else if (strcmp(argv[i], "--nodes") == 0 && hasValue) base.nodes = std::stoull(argv[++i]);
+            else if (strcmp(argv[i], "--movetime") == 0 && hasValue) base.moveTimeMs = std::stoll(argv[++i]);
+            else if (strcmp(argv[i], "--depth") == 0 && hasValue) base.depth = std::stoi(argv[++i]);
+            else if (strcmp(argv[i], "--a") == 0 && hasValue) configA = argv[++i];
+            else if (strcmp(argv[i], "--b") == 0 && hasValue) configB = argv[++i];
+            else if (strcmp(argv[i], "--openings") == 0 && hasValue) options.openingsFile = argv[++i];
+            else if (strcmp(argv[i], "--book") == 0 && hasValue) options.bookFile = argv[++i];
+            else if (strcmp(argv[i], "--random-plies") == 0 && hasValue) options.randomPlies = std::stoi(argv[++i]);
+            else if (strcmp(argv[i], "--book-plies") == 0 && hasValue) options.bookPlies = std::stoi(argv[++i]);
+            else if (strcmp(argv[i], "--max-plies") == 0 && hasValue) options.maxPlies = std::stoi(argv[++i]);
+            else if (strcmp(argv[i], "--hash") == 0 && hasValue) options.hashMB = std::stoull(argv[++i]);
+            else if (strcmp(argv[i], "--sprt") == 0 && i + 2 < argc) { options.elo0 = std::stod(argv[++i]); options.elo1 = std::stod(argv[++i]); }
+            else if (strcmp(argv[i], "--alpha") == 0 && hasValue) options.alpha = std::stod(argv[++i]);
+            else if (strcmp(argv[i], "--beta") == 0 && hasValue) options.beta = std::stod(argv[++i]);
+            else if (strcmp(argv[i], "--seed") == 0 && hasValue) options.seed = std::stoull(argv[++i]);
+            else if (strcmp(argv[i], "--out") == 0 && hasValue) options.gamesFile = argv[++i];
+            else if (strcmp(argv[i], "--stats-json") == 0 && hasValue) options.statsFile = argv[++i];
+            else { std::cerr << "Error: Unknown or incomplete argument '" << argv[i] << "'." << std::endl << usage << std::endl; return 1; }
+        } catch (const std::exception&) {
+            std::cerr << "Error: Invalid value for " << argv[i - 1] << ": '" << argv[i] << "'" << std::endl; return 1;
+        }
+    }
+    if (base.nodes == 0 && base.moveTimeMs == 0 && base.depth == 0) base.nodes = 20000;
+    EngineConfig a = base, b = base;
+    a.name = "A"; b.name = "B";
+    if (!parseEngineConfig(configA, a) || !parseEngineConfig(configB, b)) {
+        std::cerr << "Error: Invalid engine configuration (expected key=value,... with nodes, movetime, depth or a search parameter)." << std::endl;
+        return 1;
+    }
+    options.games += options.games % 2; // Whole pairs
+
+    std::vector<GameState> openingList;
+    if (!options.openingsFile.empty()) {
+        std::ifstream in(options.openingsFile);
+        if (!in.is_open()) { std::cerr << "Error opening openings file: " << options.openingsFile << std::endl; return 1; }
+        std::string line; GameState state;
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            if (state.fromNotation(line.c_str())) openingList.push_back(state);
+        }
+        if (openingList.empty()) { std::cerr << "Error: No valid positions in " << options.openingsFile << std::endl; return 1; }
+    } else if (!options.bookFile.empty() && !Book::load(options.bookFile)) {
+        std::cerr << "Error: Could not load opening book " << options.bookFile << std::endl; return 1;
+    }
+
+    std::ofstream gamesOut(options.gamesFile, std::ios::trunc);
+    if (!gamesOut.is_open()) { std::cerr << "Error opening games file for writing: " << options.gamesFile << std::endl; return 1; }
+    std::ofstream statsOut;
+    if (!options.statsFile.empty()) {
+        statsOut.open(options.statsFile, std::ios::trunc);
+        if (!statsOut.is_open()) { std::cerr << "Error opening stats file for writing: " << options.statsFile << std::endl; return 1; }
+    }
+
+    const double lowerBound = std::log(options.beta / (1.0 - options.alpha));
+    const double upperBound = std::log((1.0 - options.beta) / options.alpha);
+    int workers = std::min(options.workers, options.games / 2);
+    std::cout << "Self-play: " << options.games << " games, " << workers << " workers, SPRT elo0 " << options.elo0
+              << " elo1 " << options.elo1 << " (alpha " << options.alpha << ", beta " << options.beta << ")" << std::endl;
+
+    // --- Engines (A and B per worker) ---
+    std::vector<std::unique_ptr<Engine>> engines;
+    for (int w = 0; w < 2 * workers; ++w) {
+        engines.push_back(std::make_unique<Engine>(options.hashMB));
+#ifdef USE_TRANSPOSITION_TABLE
+        engines.back()->setPersistentTT(true); // Keep entries across a game's iterations and moves (cleared per game)
+#endif
+        engines.back()->setTimingStats(statsOut.is_open());
+    }
+
+    MatchStats stats;
+    std::string decision;
+    std::mutex resultMutex;
+    std::atomic<bool> decided{false};
+    auto handleResult = [&](const std::string (&lines)[2], const std::vector<std::string>& statsLines) {
+        std::lock_guard<std::mutex> lock(resultMutex);
+        if (decided) return; // SPRT done: drop pairs that finished afterwards
+        for (const std::string& statsLine : statsLines) statsOut << statsLine << "\n";
+        int aScoreTimes2[2] = {};
+        for (int g = 0; g < 2; ++g) {
+            std::istringstream in(lines[g]);
+            int gameIndex = 0;
+            in >> gameIndex >> aScoreTimes2[g];
+            std::string record; std::getline(in >> std::ws, record);
+            gamesOut << record << "\n";
+        }
+        stats.addPair(aScoreTimes2[0], aScoreTimes2[1]);
+        double llr = stats.llr(options.elo0, options.elo1);
+        if (llr >= upperBound) decision = "H1 accepted (A is stronger by at least elo1)";
+        else if (llr <= lowerBound) decision = "H0 accepted (A is not stronger by elo1)";
+        if (stats.games() % 10 == 0 || !decision.empty()) printStats(stats, options, lowerBound, upperBound);
+        if (!decision.empty()) {
+            decided = true;
+            for (auto& engine : engines) engine->requestStop(); // Abort games in progress
+        }
+    };
+
+    // Worker w plays pairs w, w + workers, ... (both games of a pair, so a pair is complete or stopped)
+    auto runWorker = [&](int w) {
+        Engine& engineA = *engines[2 * w];
+        Engine& engineB = *engines[2 * w + 1];
+        for (int pair = w; 2 * pair < options.games && !decided; pair += workers) {
+            std::vector<std::string> statsLines;
+            std::string lines[2];
+            for (int g = 0; g < 2; ++g) {
+                lines[g] = playMatchGame(2 * pair + g, engineA, a, engineB, b, options, openingList, statsOut.is_open() ? &statsLines : nullptr);
+                if (lines[g].empty()) break;
+            }
+            if (lines[0].empty() || lines[1].empty()) break; // Stopped: the match is decided
+            handleResult(lines, statsLines);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int w = 1; w < workers; ++w) threads.emplace_back(runWorker, w);
+    runWorker(0);
+    for (std::thread& thread : threads) thread.join();
+
+    if (stats.games() % 10 != 0 && decision.empty()) printStats(stats, options, lowerBound, upperBound);
+    std::cout << (decision.empty() ? "SPRT inconclusive after " + std::to_string(stats.games()) + " games." : "SPRT: " + decision)
+              << " Games written to " << options.gamesFile << std::endl;
+    return 0;
+}
@@ -0,0 +1,277 @@
+// SPSA tuner for the search parameters (build target: spsa)
+//
+// Each iteration perturbs every tuned parameter (SPSA_PARAMS) by +/- c_k at once, plays a batch of
+// game pairs theta+ vs theta- (same random opening, colors swapped) and moves theta along
+// the match result. Games are spread over worker threads, each with its own pair of Engine
+// instances (one per player). State is checkpointed after every iteration; the final values
+// are written in the TunedSearchParams.h format.
+
+#include "GameState.h"
+#include "AI.h"
+#include "Evaluation.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstring>   // For strcmp
+#include <cstdio>    // For std::rename
+#include <stdexcept> // For std::stoi exceptions
+#include <iomanip>   // For std::setprecision
+#include <algorithm>
+#include <thread>
+#include <memory>
+
+namespace {
+
+    // --- Tuned Parameters ---
+    // c: perturbation at iteration 1 (shrinks as k^-0.101), in parameter units.
+    // Only parameters whose benefit shows at a fixed node count belong here. lazyEvalMargin
+    // does change the search (a lazy exit returns the margin bound, which reaches the parent and
+    // the TT), but what a smaller margin buys is time per node, and fixed-node games can't reward
+    // that: it would just drift towards the most accurate setting. It keeps its calibrated default.
+    struct SpsaParam {
+        const char* name;
+        int SearchParams::*field;
+        double minValue, maxValue;
+        double c;
+    };
+
+    const SpsaParam SPSA_PARAMS[] = {
+        {"captureVictimWeight",   &SearchParams::captureVictimWeight,   1.0,   50.0,    2.0},
+        {"captureAttackerWeight", &SearchParams::captureAttackerWeight, 0.0,   10.0,    1.0},
+    };
+    constexpr size_t NUM_SPSA_PARAMS = sizeof(SPSA_PARAMS) / sizeof(SPSA_PARAMS[0]);
+
+    SearchParams toSearchParams(const std::vector<double>& theta) {
+        SearchParams params = DEFAULT_SEARCH_PARAMS;
+        for (size_t i = 0; i < NUM_SPSA_PARAMS; ++i) {
+            double v = std::clamp(theta[i], SPSA_PARAMS[i].minValue, SPSA_PARAMS[i].maxValue);
+            params.*(SPSA_PARAMS[i].field) = static_cast<int>(std::lround(v));
+        }
+        return params;
+    }
+
+    struct SpsaOptions {
+        int iterations = 500;
+        int gamePairs = 8;        // Per iteration (2 games each)
+        uint64_t nodes = 20000;   // Per move
+        int maxPlies = 200;       // Then adjudicated as a draw
+        int randomPlies = 6;      // Random opening moves before the engines take over
+        int workers = 1;
+        size_t hashMB = 16;       // Per engine (two per worker)
+        double learningRate = 0.002;
+        uint64_t seed = 1;
+        std::string checkpointFile = "spsa.checkpoint";
+        std::string outFile = "TunedSearchParams.h";
+    };
+
+    // --- Games ---
+    // Node-budgeted iterative deepening: stop before the next depth is expected to
+    // overrun the budget (estimated from the last iteration's growth). Deterministic.
+    Move searchWithNodeBudget(Engine& engine, const GameState& gameState, uint64_t nodeBudget) {
+        Move best = {-1,-1,-1,-1};
+        uint64_t total = 0, previous = 0;
+        for (int depth = 1; depth <= 64; ++depth) {
+            AIMoveInfo info = engine.getBestMove(gameState, depth, false, true);
+            if (info.bestMove.fromRow == -1) break;
+            best = info.bestMove;
+            uint64_t last = info.nodesSearched;
+            total += last;
+            if (Evaluation::isWinScore(info.finalScore)) break; // Win/loss found
+            double growth = (previous > 0) ? static_cast<double>(last) / previous : 4.0;
+            if (total + static_cast<uint64_t>(last * std::max(1.0, growth)) > nodeBudget) break;
+            previous = last;
+        }
+        return best;
+    }
+
+    // One worker's engines: engine 0 plays Player 1, engine 1 Player 2
+    struct EnginePair {
+        std::unique_ptr<Engine> engines[2];
+    };
+
+    // Result from Player 2's view: +1 win, 0 draw, -1 loss
+    int playGame(EnginePair& pair, const SearchParams& player1Params, const SearchParams& player2Params, uint64_t openingSeed, const SpsaOptions& options) {
+        GameState gameState;
+        std::mt19937_64 rng(openingSeed);
+        for (int ply = 0; ply < options.randomPlies; ++ply) {
+            std::vector<Move> moves = gameState.getAllLegalMoves(gameState.getCurrentPlayer());
+            if (moves.empty()) break;
+            gameState.applyMove(moves[rng() % moves.size()]);
+            if (gameState.checkWinner() != Player::NONE) return 0; // Can't happen in a few plies; don't score it
+            gameState.switchPlayer();
+        }
+
+        // Fresh TTs per game, kept across the game's searches (engines are persistent, see main)
+        pair.engines[0]->setSearchParams(player1Params);
+        pair.engines[1]->setSearchParams(player2Params);
+#ifdef USE_TRANSPOSITION_TABLE
+        for (auto& engine : pair.engines) engine->clearTT();
+#endif
+
+        for (int ply = 0; ply < options.maxPlies; ++ply) {
+            Player toMove = gameState.getCurrentPlayer();
+            if (gameState.getAllLegalMoves(toMove).empty()) return toMove == Player::PLAYER2 ? -1 : 1;
+            Engine& engine = *pair.engines[toMove == Player::PLAYER1 ? 0 : 1];
+            Move move = searchWithNodeBudget(engine, gameState, options.nodes);
+            gameState.applyMove(move);
+            Player winner = gameState.checkWinner();
+            if (winner != Player::NONE) return winner == Player::PLAYER2 ? 1 : -1;
+            gameState.switchPlayer();
+        }
+        return 0;
+    }
+
+    // Game pair j: theta+ plays Player 2 in game 2j and Player 1 in game 2j + 1. Returns theta+'s score.
+    int playPair(EnginePair& pair, const SearchParams& plus, const SearchParams& minus, uint64_t openingSeed, const SpsaOptions& options) {
+        return playGame(pair, minus, plus, openingSeed, options) - playGame(pair, plus, minus, openingSeed, options);
+    }
+
+    // --- Batch Over Worker Threads ---
+    // Per-pair results (+2..-2) in pair order, so a batch is reproducible for any worker count.
+    std::vector<int> playBatch(std::vector<EnginePair>& enginePairs, const SearchParams& plus, const SearchParams& minus,
+                               uint64_t batchSeed, const SpsaOptions& options) {
+        std::vector<int> results(options.gamePairs, 0);
+        int workers = std::max(1, std::min(static_cast<int>(enginePairs.size()), options.gamePairs));
+        auto runWorker = [&](int w) {
+            for (int j = w; j < options.gamePairs; j += workers) results[j] = playPair(enginePairs[w], plus, minus, batchSeed + j, options);
+        };
+        std::vector<std::thread> threads;
+        for (int w = 1; w < workers; ++w) threads.emplace_back(runWorker, w);
+        runWorker(0);
+        for (std::thread& thread : threads) thread.join();
+        return results;
+    }
+
+    // --- Checkpoint (text: "iteration N", then "name value" per parameter) ---
+    bool saveCheckpoint(const std::string& filename, int iteration, const std::vector<double>& theta) {
+        std::string tmpName = filename + ".tmp";
+        {
+            std::ofstream out(tmpName, std::ios::trunc);
+            if (!out.is_open()) return false;
+            out << "iteration " << iteration << "\n" << std::setprecision(17);
+            for (size_t i = 0; i < NUM_SPSA_PARAMS; ++i) out << SPSA_PARAMS[i].name << " " << theta[i] << "\n";
+            if (out.fail()) return false;
+        }
+        return std::rename(tmpName.c_str(), filename.c_str()) == 0;
+    }
+
+    bool loadCheckpoint(const std::string& filename, int& iteration, std::vector<double>& theta) {
+        std::ifstream in(filename);
+        if (!in.is_open()) return false;
+        std::string key; double value;
+        if (!(in >> key >> iteration) || key != "iteration") return false;
+        while (in >> key >> value) {
+            for (size_t i = 0; i < NUM_SPSA_PARAMS; ++i) if (key == SPSA_PARAMS[i].name) theta[i] = value;
+        }
+        return true;
+    }
+
+    bool writeParamsHeader(const SearchParams& params, const std::string& filename, int iterations) {
+        std::ofstream out(filename, std::ios::trunc);
+        if (!out.is_open()) { std::cerr << "Error opening output header for writing: " << filename << std::endl; return false; }
+        out << "#pragma once\n"
+            << "// Search parameter defaults. This file is (re)generated by the spsa tool (src/Spsa.cpp);\n"
+            << "// hand edits are fine, but a tuning run writes a complete new copy.\n"
+            << "// Last tuning run: " << iterations << " SPSA iterations.\n\n"
+            << "#include \"SearchParams.h\"\n\n"
+            << "inline constexpr SearchParams DEFAULT_SEARCH_PARAMS = {\n";
+        // Every field in declaration order (untuned ones keep their current default)
+        constexpr size_t numFields = sizeof(SEARCH_PARAM_FIELDS) / sizeof(SEARCH_PARAM_FIELDS[0]);
+        for (size_t i = 0; i < numFields; ++i) {
+            out << "    " << params.*(SEARCH_PARAM_FIELDS[i].field) << (i + 1 < numFields ? "," : " ") << " // " << SEARCH_PARAM_FIELDS[i].name << "\n";
+        }
+        out << "};\n";
+        return !out.fail();
+    }
+
+} // namespace
+
+
+int main(int argc, char* argv[]) {
+    const char* progName = (argc > 0 && argv[0] != nullptr) ? argv[0] : "spsa";
+    std::string usage = std::string("Usage: ") + progName +
+        " [--iterations N] [--pairs N] [--nodes N] [--workers N] [--hash MB] [--max-plies N] [--random-plies N]"
+        " [--lr X] [--seed N] [--checkpoint FILE] [--out FILE]";
+    SpsaOptions options;
+    options.workers = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) { std::cout << usage << std::endl; return 0; }
+        bool hasValue = (i + 1 < argc);
+        try {
+            if (strcmp(argv[i], "--iterations") == 0 && hasValue) options.iterations = std::stoi(argv[++i]);
+            else if (strcmp(argv[i], "--pairs") == 0 && hasValue) options.gamePairs = std::max(1, std::stoi(argv[++i]));
+            else if (strcmp(argv[i], "--nodes") == 0 && hasValue) options.nodes = std::stoull(argv[++i]);
+            else if (strcmp(argv[i], "--workers") == 0 && hasValue) options.workers = std::max(1, std::stoi(argv[++i]));
+            else if (strcmp(argv[i], "--hash") == 0 && hasValue) options.hashMB = std::max<size_t>(1, std::stoull(argv[++i]));
+            else if (strcmp(argv[i], "--max-plies") == 0 && hasValue) options.maxPlies = std::stoi(argv[++i]);
+            else if (strcmp(argv[i], "--random-plies") == 0 && hasValue) options.randomPlies = std::stoi(argv[++i]);
+            else if (strcmp(argv[i], "--lr") == 0 && hasValue) options.learningRate = std::stod(argv[++i]);
+            else if (strcmp(argv[i], "--seed") == 0 && hasValue) options.seed = std::stoull(argv[++i]);
+            else if (strcmp(argv[i], "--checkpoint") == 0 && hasValue) options.checkpointFile = argv[++i];
+            else if (strcmp(argv[i], "--out") == 0 && hasValue) options.outFile = argv[++i];
+            else { std::cerr << "Error: Unknown or incomplete argument '" << argv[i] << "'." << std::endl << usage << std::endl; return 1; }
+        } catch (const std::exception&) {
+            std::cerr << "Error: Invalid value for " << argv[i - 1] << ": '" << argv[i] << "'" << std::endl; return 1;
+        }
+    }
+
+    std::vector<double> theta(NUM_SPSA_PARAMS);
+    for (size_t i = 0; i < NUM_SPSA_PARAMS; ++i) theta[i] = DEFAULT_SEARCH_PARAMS.*(SPSA_PARAMS[i].field);
+    int startIteration = 1;
+    int doneIterations = 0;
+    if (loadCheckpoint(options.checkpointFile, doneIterations, theta)) {
+        startIteration = doneIterations + 1;
+        std::cout << "Resuming from " << options.checkpointFile << " after iteration " << doneIterations << "." << std::endl;
+    }
+
+    std::vector<EnginePair> enginePairs(std::max(1, std::min(options.workers, options.gamePairs)));
+    for (EnginePair& pair : enginePairs) {
+        for (auto& engine : pair.engines) {
+            engine = std::make_unique<Engine>(options.hashMB);
+#ifdef USE_TRANSPOSITION_TABLE
+            engine->setPersistentTT(true); // Cleared per game instead of per search
+#endif
+        }
+    }
+    std::cout << "SPSA: " << options.iterations << " iterations x " << options.gamePairs << " game pairs, "
+              << options.nodes << " nodes/move, " << options.workers << " workers." << std::endl;
+
+    // Standard gains: a_k = a / (A + k)^0.602, c_k = c / k^0.101, A = 10% of the run
+    const double stabilityA = 0.1 * options.iterations;
+    std::mt19937_64 deltaRng(options.seed);
+    deltaRng.discard(static_cast<unsigned long long>(startIteration - 1) * NUM_SPSA_PARAMS); // Same perturbations when resumed
+    for (int k = startIteration; k <= options.iterations; ++k) {
+        double ak = options.learningRate * std::pow(stabilityA + 1.0, 0.602) / std::pow(stabilityA + k, 0.602);
+        std::vector<double> plusTheta(theta), minusTheta(theta), delta(NUM_SPSA_PARAMS), ck(NUM_SPSA_PARAMS);
+        for (size_t i = 0; i < NUM_SPSA_PARAMS; ++i) {
+            delta[i] = (deltaRng() & 1) ? 1.0 : -1.0;
+            ck[i] = SPSA_PARAMS[i].c / std::pow(k, 0.101);
+            plusTheta[i] += ck[i] * delta[i];
+            minusTheta[i] -= ck[i] * delta[i];
+        }
+
+        std::vector<int> pairResults = playBatch(enginePairs, toSearchParams(plusTheta), toSearchParams(minusTheta),
+                                                 options.seed * 1000003ULL + static_cast<uint64_t>(k) * options.gamePairs, options);
+        int score = 0; // theta+ wins minus losses
+        for (int r : pairResults) score += r;
+
+        // theta += a_k * c_k * score * delta: the step scales with each parameter's perturbation size
+        for (size_t i = 0; i < NUM_SPSA_PARAMS; ++i) {
+            theta[i] = std::clamp(theta[i] + ak * ck[i] * score * delta[i], SPSA_PARAMS[i].minValue, SPSA_PARAMS[i].maxValue);
+        }
+
+        std::cout << "Iteration " << k << ": theta+ score " << (score >= 0 ? "+" : "") << score << "/" << 2 * options.gamePairs << " |";
+        for (size_t i = 0; i < NUM_SPSA_PARAMS; ++i) std::cout << " " << SPSA_PARAMS[i].name << "=" << std::fixed << std::setprecision(2) << theta[i];
+        std::cout << std::defaultfloat << std::endl;
+        if (!saveCheckpoint(options.checkpointFile, k, theta)) std::cerr << "Warning: Failed to write checkpoint " << options.checkpointFile << std::endl;
+    }
+
+    SearchParams tuned = toSearchParams(theta);
+    if (!writeParamsHeader(tuned, options.outFile, options.iterations)) return 1;
+    std::cout << "Tuned parameters written to " << options.outFile << " (copy over include/TunedSearchParams.h and rebuild)." << std::endl;
+    return 0;
+}
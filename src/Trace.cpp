@@ -0,0 +1,197 @@
+#include "Trace.h"
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <cstring>   // For std::strncpy
+
+namespace Trace {
+
+    namespace {
+
+        struct Event {
+            const char* name;
+            const char* category;
+            int64_t startNs;
+            int64_t durationNs;
+            const char* argKey;
+            int64_t argValue;
+            char detail[16];
+        };
+
+        // Owned by the registry so events outlive their thread. A thread that exits hands its
+        // buffer to the next new thread (one track per concurrently running thread, not per
+        // thread ever started, e.g. the engine's search thread per "go").
+        struct ThreadBuffer {
+            std::vector<Event> events; // Ring: next write at head, full once wrapped
+            size_t head = 0;
+            bool wrapped = false;
+            uint32_t threadId = 0;
+            std::string threadName;
+            uint64_t generation = 0;   // Buffers from an earlier start() are reset on first use
+            bool inUse = false;        // Owned by a running thread (guarded by registryMutex)
+        };
+
+        std::atomic<bool> enabled{false};
+        std::atomic<uint64_t> currentGeneration{0};
+#ifdef USE_TRACING
+        size_t eventsPerThread = DEFAULT_EVENTS_PER_THREAD;
+#endif // USE_TRACING
+        std::chrono::steady_clock::time_point traceStart;
+
+        std::mutex registryMutex; // Guards buffers (taking/returning one, and writeJson)
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+        struct ThreadSlot {
+            ThreadBuffer* buffer = nullptr;
+            ~ThreadSlot() {
+                if (!buffer) return;
+                std::lock_guard<std::mutex> lock(registryMutex);
+                buffer->inUse = false;
+            }
+        };
+        thread_local ThreadSlot localSlot;
+
+#ifdef USE_TRACING
+        ThreadBuffer& threadBuffer() {
+            ThreadBuffer*& localBuffer = localSlot.buffer;
+            if (!localBuffer) {
+                std::lock_guard<std::mutex> lock(registryMutex);
+                for (const auto& buffer : buffers) {
+                    if (!buffer->inUse) { localBuffer = buffer.get(); break; }
+                }
+                if (!localBuffer) {
+                    buffers.push_back(std::make_unique<ThreadBuffer>());
+                    localBuffer = buffers.back().get();
+                    localBuffer->threadId = static_cast<uint32_t>(buffers.size());
+                }
+                localBuffer->inUse = true;
+            }
+            uint64_t generation = currentGeneration.load(std::memory_order_acquire);
+            if (localBuffer->generation != generation) {
+                localBuffer->events.assign(eventsPerThread, Event{});
+                localBuffer->head = 0;
+                localBuffer->wrapped = false;
+                localBuffer->generation = generation;
+            }
+            return *localBuffer;
+        }
+
+        int64_t nowNs() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - traceStart).count();
+        }
+#endif // USE_TRACING
+
+        void writeEscaped(std::ostream& out, const char* text) {
+            for (const char* p = text; *p; ++p) {
+                if (*p == '"' || *p == '\\') out << '\\';
+                if (static_cast<unsigned char>(*p) >= 0x20) out << *p;
+            }
+        }
+
+    } // namespace
+
+    bool start(size_t eventCapacity) {
+#ifdef USE_TRACING
+        eventsPerThread = eventCapacity > 0 ? eventCapacity : DEFAULT_EVENTS_PER_THREAD;
+        traceStart = std::chrono::steady_clock::now();
+        currentGeneration.fetch_add(1, std::memory_order_acq_rel);
+        enabled.store(true, std::memory_order_release);
+        return true;
+#else
+        (void)eventCapacity;
+        return false;
+#endif // USE_TRACING
+    }
+
+    void stop() {
+        enabled.store(false, std::memory_order_release);
+    }
+
+    bool isEnabled() {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    void setThreadName(const std::string& name) {
+#ifdef USE_TRACING
+        threadBuffer().threadName = name;
+#else
+        (void)name;
+#endif // USE_TRACING
+    }
+
+    // --- Chrome Trace Event JSON ---
+    // {"traceEvents":[thread_name metadata..., {"name","cat","ph":"X","ts","dur","pid","tid","args"}...]}
+    // Timestamps are microseconds since start().
+    bool writeJson(const std::string& filename) {
+        std::ofstream out(filename, std::ios::trunc);
+        if (!out.is_open()) { std::cerr << "Error opening trace file for writing: " << filename << std::endl; return false; }
+        std::lock_guard<std::mutex> lock(registryMutex);
+        uint64_t generation = currentGeneration.load(std::memory_order_acquire);
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        bool first = true;
+        for (const auto& buffer : buffers) {
+            if (buffer->generation != generation) continue; // Nothing recorded since the last start()
+            if (!buffer->threadName.empty()) {
+                out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId
+                    << ",\"args\":{\"name\":\"";
+                writeEscaped(out, buffer->threadName.c_str());
+                out << "\"}}";
+                first = false;
+            }
+            size_t count = buffer->wrapped ? buffer->events.size() : buffer->head;
+            size_t begin = buffer->wrapped ? buffer->head : 0; // Oldest first
+            for (size_t i = 0; i < count; ++i) {
+                const Event& event = buffer->events[(begin + i) % buffer->events.size()];
+                out << (first ? "" : ",\n") << "{\"name\":\"";
+                writeEscaped(out, event.name);
+                out << "\",\"cat\":\"";
+                writeEscaped(out, event.category);
+                out << "\",\"ph\":\"X\",\"ts\":" << event.startNs / 1000 << "." << (event.startNs % 1000) / 100
+                    << ",\"dur\":" << event.durationNs / 1000 << "." << (event.durationNs % 1000) / 100
+                    << ",\"pid\":1,\"tid\":" << buffer->threadId;
+                if (event.argKey || event.detail[0]) {
+                    out << ",\"args\":{";
+                    if (event.argKey) { out << "\""; writeEscaped(out, event.argKey); out << "\":" << event.argValue; }
+                    if (event.detail[0]) { out << (event.argKey ? "," : "") << "\"detail\":\""; writeEscaped(out, event.detail); out << "\""; }
+                    out << "}";
+                }
+                out << "}";
+                first = false;
+            }
+        }
+        out << "\n]}\n";
+        return !out.fail();
+    }
+
+    // --- Scope ---
+    Scope::Scope(const char* eventName, const char* eventCategory) : name(eventName), category(eventCategory) {
+#ifdef USE_TRACING
+        if (enabled.load(std::memory_order_relaxed)) startNs = nowNs();
+#endif // USE_TRACING
+    }
+
+    Scope::~Scope() {
+#ifdef USE_TRACING
+        if (startNs < 0 || !enabled.load(std::memory_order_relaxed)) return;
+        ThreadBuffer& buffer = threadBuffer();
+        Event& event = buffer.events[buffer.head];
+        event.name = name;
+        event.category = category;
+        event.startNs = startNs;
+        event.durationNs = nowNs() - startNs;
+        event.argKey = argKey;
+        event.argValue = argValue;
+        std::memcpy(event.detail, detail, sizeof(detail));
+        if (++buffer.head == buffer.events.size()) { buffer.head = 0; buffer.wrapped = true; }
+#endif // USE_TRACING
+    }
+
+    void Scope::setDetail(const std::string& text) {
+        std::strncpy(detail, text.c_str(), sizeof(detail) - 1);
+        detail[sizeof(detail) - 1] = '\0';
+    }
+
+} // namespace Trace
@@ -0,0 +1,305 @@
+// Texel tuner for the classic evaluation (build target: tune)
+//
+// Minimizes the mean squared error between game results and sigmoid(K * evaluateBoard())
+// over a labelled position file, then writes a new TunedEvalParams.h.
+//   - PST entries enter the score linearly, so their gradient is exact (feature counts).
+//   - Piece values and term weights also feed non-linear terms (trap control, threats),
+//     so their gradient comes from central finite differences over the whole set.
+// Each pass over the positions is split across threads; Adam does the updates.
+//
+// Position file: one position per line, '#' starts a comment:
+//   <position notation (GameState::toNotation)> <result for Player 2: 1 win, 0.5 draw, 0 loss>
+// e.g. "t5l/1c3d1/e1w1p1r/7/7/7/R1P1W1E/1D3C1/L5T 1 0.5"
+
+#include "GameState.h"
+#include "Evaluation.h"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <cmath>
+#include <cstring>   // For strcmp
+#include <cstdlib>   // For std::strtod
+#include <stdexcept> // For std::stoi exceptions
+#include <iomanip>   // For std::setprecision
+#include <algorithm>
+
+namespace {
+
+    struct TunePosition {
+        GameState state;
+        double result; // From Player 2's view, like evaluateBoard()
+    };
+
+    // --- Position File Parsing ---
+    bool parsePositionLine(const std::string& line, TunePosition& out) {
+        const char* rest = nullptr;
+        if (!out.state.fromNotation(line.c_str(), &rest)) return false;
+        char* resultEnd = nullptr;
+        double result = std::strtod(rest, &resultEnd);
+        if (resultEnd == rest || result < 0.0 || result > 1.0) return false;
+        out.result = result;
+        return out.state.checkWinner() == Player::NONE; // Den already entered: nothing to learn
+    }
+
+    bool loadPositions(const std::string& filename, std::vector<TunePosition>& positions, size_t limit) {
+        std::ifstream inFile(filename);
+        if (!inFile.is_open()) { std::cerr << "Error opening position file: " << filename << std::endl; return false; }
+        std::string line; size_t lineNumber = 0, skipped = 0;
+        while (std::getline(inFile, line) && (limit == 0 || positions.size() < limit)) {
+            ++lineNumber;
+            if (line.empty() || line[0] == '#') continue;
+            TunePosition position;
+            if (parsePositionLine(line, position)) positions.push_back(std::move(position));
+            else ++skipped;
+        }
+        if (skipped > 0) std::cerr << "Warning: Skipped " << skipped << " malformed or finished positions." << std::endl;
+        return !positions.empty();
+    }
+
+    // --- Tunable Parameter List ---
+    // Points into a working EvalParams; `step` is the finite-difference delta and the unit Adam works in.
+    struct TunableParam {
+        std::string name;
+        int* intValue;
+        double* doubleValue;
+        double step;
+        int pstIndex; // >= 0: PST entry (analytic gradient), flat index pstIndex * 63 + square
+        double get() const { return intValue ? *intValue : *doubleValue; }
+        void set(double v) { if (intValue) *intValue = static_cast<int>(std::lround(v)); else *doubleValue = v; }
+    };
+
+    std::vector<TunableParam> buildTunableParams(Evaluation::EvalParams& p) {
+        static const char* pieceNames[] = {"", "RAT", "CAT", "DOG", "WOLF", "LEOPARD", "TIGER", "LION", "ELEPHANT"};
+        std::vector<TunableParam> list;
+        for (int t = 1; t <= static_cast<int>(PieceType::ELEPHANT); ++t) list.push_back({std::string("pieceValue.") + pieceNames[t], &p.pieceValue[t], nullptr, 50.0, -1});
+        list.push_back({"mobilityWeight", &p.mobilityWeight, nullptr, 1.0, -1});
+        list.push_back({"captureThreatPct", &p.captureThreatPct, nullptr, 1.0, -1});
+        list.push_back({"elephantTrapPenalty", &p.elephantTrapPenalty, nullptr, 50.0, -1});
+        list.push_back({"ratInterceptMaxBonus", &p.ratInterceptMaxBonus, nullptr, 50.0, -1});
+        list.push_back({"denSafetyBaseScore", &p.denSafetyBaseScore, nullptr, 5.0, -1});
+        list.push_back({"denSafetyCountMultiplier", nullptr, &p.denSafetyCountMultiplier, 0.05, -1});
+        list.push_back({"trappedCornerMalusPct", nullptr, &p.trappedCornerMalusPct, 0.01, -1});
+        list.push_back({"trappedDist1MalusPct", nullptr, &p.trappedDist1MalusPct, 0.01, -1});
+        list.push_back({"trappedDist2MalusPct", nullptr, &p.trappedDist2MalusPct, 0.01, -1});
+        list.push_back({"trapControlSuicidePenaltyPct", &p.trapControlSuicidePenaltyPct, nullptr, 1.0, -1});
+        list.push_back({"trapControlLosingPenaltyPct", &p.trapControlLosingPenaltyPct, nullptr, 1.0, -1});
+        list.push_back({"trapControlWinningBonus", &p.trapControlWinningBonus, nullptr, 50.0, -1});
+        list.push_back({"trapControlSafeBonus", &p.trapControlSafeBonus, nullptr, 50.0, -1});
+        for (int i = 0; i < Evaluation::NUM_PSTS; ++i)
+            for (int r = 0; r < BOARD_ROWS; ++r)
+                for (int c = 0; c < BOARD_COLS; ++c)
+                    list.push_back({"pst", &p.pst[i][r][c], nullptr, 1.0, i * BOARD_ROWS * BOARD_COLS + r * BOARD_COLS + c});
+        return list;
+    }
+
+    constexpr int NUM_PST_ENTRIES = Evaluation::NUM_PSTS * BOARD_ROWS * BOARD_COLS;
+
+    double sigmoid(double k, int score) { return 1.0 / (1.0 + std::exp(-k * score)); }
+
+    // --- Threaded Passes Over the Position Set ---
+    // Each pass refreshes the incremental terms (the tables changed with the parameters)
+    // and evaluates every position. Threads own disjoint contiguous chunks.
+    template <typename Work>
+    void runChunks(size_t count, unsigned threadCount, Work work) {
+        std::vector<std::thread> workers;
+        size_t chunk = (count + threadCount - 1) / threadCount;
+        for (unsigned t = 0; t < threadCount; ++t) {
+            size_t begin = t * chunk, end = std::min(count, begin + chunk);
+            if (begin >= end) break;
+            workers.emplace_back(work, t, begin, end);
+        }
+        for (std::thread& worker : workers) worker.join();
+    }
+
+    void refreshAndEvaluate(std::vector<TunePosition>& positions, std::vector<int>& scores, unsigned threadCount) {
+        scores.resize(positions.size());
+        runChunks(positions.size(), threadCount, [&](unsigned, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                positions[i].state.setBoard(positions[i].state.getBoard());
+                scores[i] = Evaluation::evaluateBoard(positions[i].state);
+            }
+        });
+    }
+
+    double meanSquaredError(const std::vector<TunePosition>& positions, const std::vector<int>& scores, double k) {
+        double sum = 0.0;
+        for (size_t i = 0; i < positions.size(); ++i) { double d = positions[i].result - sigmoid(k, scores[i]); sum += d * d; }
+        return sum / positions.size();
+    }
+
+    double errorWithParams(const Evaluation::EvalParams& p, std::vector<TunePosition>& positions, std::vector<int>& scores, double k, unsigned threadCount) {
+        if (!Evaluation::setParams(p)) return -1.0; // Out of range for the packed tables
+        refreshAndEvaluate(positions, scores, threadCount);
+        return meanSquaredError(positions, scores, k);
+    }
+
+    // Scaling constant K: ternary search in log space (the error is unimodal in K)
+    double fitScalingConstant(const std::vector<TunePosition>& positions, const std::vector<int>& scores) {
+        double lo = std::log(1e-6), hi = std::log(1e-2);
+        for (int i = 0; i < 60; ++i) {
+            double m1 = lo + (hi - lo) / 3.0, m2 = hi - (hi - lo) / 3.0;
+            if (meanSquaredError(positions, scores, std::exp(m1)) < meanSquaredError(positions, scores, std::exp(m2))) hi = m2; else lo = m1;
+        }
+        return std::exp((lo + hi) / 2.0);
+    }
+
+    // d(error)/d(pst entry): -2/N * sum (result - s) * s * (1 - s) * K * (+1 per Player 2 piece, -1 per Player 1 piece on that entry)
+    void pstGradient(const std::vector<TunePosition>& positions, const std::vector<int>& scores, double k, unsigned threadCount, std::vector<double>& gradient) {
+        std::vector<std::vector<double>> partial(threadCount, std::vector<double>(NUM_PST_ENTRIES, 0.0));
+        runChunks(positions.size(), threadCount, [&](unsigned t, size_t begin, size_t end) {
+            std::vector<double>& g = partial[t];
+            for (size_t i = begin; i < end; ++i) {
+                double s = sigmoid(k, scores[i]);
+                double weight = -2.0 * (positions[i].result - s) * s * (1.0 - s) * k;
+                const auto& board = positions[i].state.getBoard();
+                for (int r = 0; r < BOARD_ROWS; ++r) {
+                    for (int c = 0; c < BOARD_COLS; ++c) {
+                        const Piece& piece = board[r][c];
+                        int index = Evaluation::pstIndexFor(piece.type);
+                        if (index < 0 || piece.owner == Player::NONE) continue;
+                        int tableRow = (piece.owner == Player::PLAYER1) ? r : (BOARD_ROWS - 1 - r);
+                        double sign = (piece.owner == Player::PLAYER2) ? 1.0 : -1.0;
+                        g[index * BOARD_ROWS * BOARD_COLS + tableRow * BOARD_COLS + c] += sign * weight;
+                    }
+                }
+            }
+        });
+        gradient.assign(NUM_PST_ENTRIES, 0.0);
+        for (const auto& g : partial) for (int e = 0; e < NUM_PST_ENTRIES; ++e) gradient[e] += g[e] / positions.size();
+    }
+
+    // --- Generated Header ---
+    bool writeParamsHeader(const Evaluation::EvalParams& p, const std::string& filename, double k, double error, size_t positionCount) {
+        std::ofstream out(filename, std::ios::trunc);
+        if (!out.is_open()) { std::cerr << "Error opening output header for writing: " << filename << std::endl; return false; }
+        static const char* pstNames[] = {"PST_RAT", "PST_CAT_DOG", "PST_WOLF", "PST_LEOPARD", "PST_TIGER", "PST_LION", "PST_ELEPHANT"};
+        out << "#pragma once\n"
+            << "// Evaluation parameter defaults. This file is (re)generated by the tune tool (src/Tune.cpp);\n"
+            << "// hand edits are fine, but a tuning run writes a complete new copy.\n"
+            << "// Last tuning run: " << positionCount << " positions, K = " << std::setprecision(6) << k
+            << ", mean squared error " << std::setprecision(8) << error << ".\n\n"
+            << "#include \"EvalParams.h\"\n\n"
+            << "namespace Evaluation {\n\n"
+            << "    inline constexpr EvalParams DEFAULT_EVAL_PARAMS = {\n"
+            << "        // pieceValue: EMPTY, RAT, CAT, DOG, WOLF, LEOPARD, TIGER, LION, ELEPHANT\n        {{";
+        for (size_t t = 0; t < p.pieceValue.size(); ++t) out << (t ? ", " : "") << p.pieceValue[t];
+        out << "}},\n        {{\n";
+        for (int i = 0; i < Evaluation::NUM_PSTS; ++i) {
+            out << "            // " << pstNames[i] << "\n            {{\n";
+            for (int r = 0; r < BOARD_ROWS; ++r) {
+                out << "                {{";
+                for (int c = 0; c < BOARD_COLS; ++c) out << (c ? "," : "") << std::setw(4) << p.pst[i][r][c];
+                out << "}}" << (r + 1 < BOARD_ROWS ? "," : "") << "\n";
+            }
+            out << "            }}" << (i + 1 < Evaluation::NUM_PSTS ? "," : "") << "\n";
+        }
+        out << std::setprecision(6)
+            << "        }},\n"
+            << "        " << p.mobilityWeight << ", // mobilityWeight\n"
+            << "        " << p.captureThreatPct << ", // captureThreatPct\n"
+            << "        " << p.elephantTrapPenalty << ", // elephantTrapPenalty\n"
+            << "        " << p.ratInterceptMaxBonus << ", // ratInterceptMaxBonus\n"
+            << "        " << p.denSafetyBaseScore << ", // denSafetyBaseScore\n"
+            << "        " << std::showpoint << p.denSafetyCountMultiplier << ", // denSafetyCountMultiplier\n"
+            << "        " << p.trappedCornerMalusPct << ", // trappedCornerMalusPct\n"
+            << "        " << p.trappedDist1MalusPct << ", // trappedDist1MalusPct\n"
+            << "        " << p.trappedDist2MalusPct << ", // trappedDist2MalusPct\n" << std::noshowpoint
+            << "        " << p.trapControlSuicidePenaltyPct << ", // trapControlSuicidePenaltyPct\n"
+            << "        " << p.trapControlLosingPenaltyPct << ", // trapControlLosingPenaltyPct\n"
+            << "        " << p.trapControlWinningBonus << ", // trapControlWinningBonus\n"
+            << "        " << p.trapControlSafeBonus << "  // trapControlSafeBonus\n"
+            << "    };\n\n"
+            << "} // namespace Evaluation\n";
+        return !out.fail();
+    }
+
+} // namespace
+
+
+int main(int argc, char* argv[]) {
+    const char* progName = (argc > 0 && argv[0] != nullptr) ? argv[0] : "tune";
+    std::string usage = std::string("Usage: ") + progName +
+        " <positions-file> [--iterations N] [--threads N] [--lr X] [--k X] [--limit N] [--out FILE]";
+    if (argc < 2 || strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0) { std::cout << usage << std::endl; return argc < 2 ? 1 : 0; }
+
+    std::string positionFile = argv[1];
+    std::string outFile = "TunedEvalParams.h";
+    int iterations = 200;
+    unsigned threadCount = std::max(1u, std::thread::hardware_concurrency());
+    double learningRate = 1.0; // In units of each parameter's step
+    double k = 0.0;            // 0 = fit to the data first
+    size_t limit = 0;
+    for (int i = 2; i < argc; ++i) {
+        bool hasValue = (i + 1 < argc);
+        try {
+            if (strcmp(argv[i], "--iterations") == 0 && hasValue) iterations = std::stoi(argv[++i]);
+            else if (strcmp(argv[i], "--threads") == 0 && hasValue) threadCount = static_cast<unsigned>(std::max(1, std::stoi(argv[++i])));
+            else if (strcmp(argv[i], "--lr") == 0 && hasValue) learningRate = std::stod(argv[++i]);
+            else if (strcmp(argv[i], "--k") == 0 && hasValue) k = std::stod(argv[++i]);
+            else if (strcmp(argv[i], "--limit") == 0 && hasValue) limit = static_cast<size_t>(std::stoll(argv[++i]));
+            else if (strcmp(argv[i], "--out") == 0 && hasValue) outFile = argv[++i];
+            else { std::cerr << "Error: Unknown or incomplete argument '" << argv[i] << "'." << std::endl << usage << std::endl; return 1; }
+        } catch (const std::exception&) {
+            std::cerr << "Error: Invalid value for " << argv[i - 1] << ": '" << argv[i] << "'" << std::endl; return 1;
+        }
+    }
+
+    std::vector<TunePosition> positions;
+    if (!loadPositions(positionFile, positions, limit)) { std::cerr << "Error: No usable positions in " << positionFile << std::endl; return 1; }
+    std::cout << "Loaded " << positions.size() << " positions, tuning with " << threadCount << " threads." << std::endl;
+
+    Evaluation::EvalParams current = Evaluation::params;
+    std::vector<TunableParam> tunables = buildTunableParams(current);
+    std::vector<int> scores;
+    refreshAndEvaluate(positions, scores, threadCount);
+    if (k <= 0.0) k = fitScalingConstant(positions, scores);
+    double bestError = meanSquaredError(positions, scores, k);
+    Evaluation::EvalParams best = current;
+    std::cout << "K = " << k << ", initial error " << std::setprecision(8) << bestError << std::endl;
+
+    // Adam state, in units of each parameter's step
+    const double beta1 = 0.9, beta2 = 0.999, epsilon = 1e-8;
+    std::vector<double> value(tunables.size()), m(tunables.size(), 0.0), v(tunables.size(), 0.0), gradient(tunables.size(), 0.0);
+    for (size_t j = 0; j < tunables.size(); ++j) value[j] = tunables[j].get();
+
+    std::vector<int> probeScores;
+    std::vector<double> pstGrad;
+    for (int iteration = 1; iteration <= iterations; ++iteration) {
+        // Base pass (also gives the PST gradient)
+        double error = errorWithParams(current, positions, scores, k, threadCount);
+        pstGradient(positions, scores, k, threadCount, pstGrad);
+        for (size_t j = 0; j < tunables.size(); ++j) {
+            TunableParam& param = tunables[j];
+            if (param.pstIndex >= 0) { gradient[j] = pstGrad[param.pstIndex]; continue; }
+            double original = param.get();
+            param.set(original + param.step);
+            double errorUp = errorWithParams(current, positions, probeScores, k, threadCount);
+            param.set(original - param.step);
+            double errorDown = errorWithParams(current, positions, probeScores, k, threadCount);
+            param.set(original);
+            gradient[j] = (errorUp < 0.0 || errorDown < 0.0) ? 0.0 : (errorUp - errorDown) / (2.0 * param.step);
+        }
+
+        for (size_t j = 0; j < tunables.size(); ++j) {
+            double g = gradient[j] * tunables[j].step; // Normalize to step units
+            m[j] = beta1 * m[j] + (1.0 - beta1) * g;
+            v[j] = beta2 * v[j] + (1.0 - beta2) * g * g;
+            double mHat = m[j] / (1.0 - std::pow(beta1, iteration));
+            double vHat = v[j] / (1.0 - std::pow(beta2, iteration));
+            value[j] -= learningRate * tunables[j].step * mHat / (std::sqrt(vHat) + epsilon);
+            tunables[j].set(value[j]);
+        }
+
+        if (error >= 0.0 && error < bestError) { bestError = error; best = current; }
+        std::cout << "Iteration " << iteration << ": error " << std::setprecision(8) << error << std::endl;
+    }
+
+    // Final parameters may be better than any probed so far
+    double finalError = errorWithParams(current, positions, scores, k, threadCount);
+    if (finalError >= 0.0 && finalError < bestError) { bestError = finalError; best = current; }
+    if (!writeParamsHeader(best, outFile, k, bestError, positions.size())) return 1;
+    std::cout << "Best error " << std::setprecision(8) << bestError << ", parameters written to " << outFile << std::endl;
+    return 0;
+}
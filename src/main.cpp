@@ -4,6 +4,9 @@
 #include "AI.h"
 #include "Common.h"
 #include "Book.h"       // Include Book.h for opening book functionality & editor saving
+#include "NNUE.h"       // Optional neural network evaluator (--eval nnue)
+#include "Bench.h"      // Built-in search benchmark (--bench)
+#include "Trace.h"      // Timeline tracing (--trace)
 #include <iostream>
 #include <vector>
 #include <string>
@@ -94,10 +97,18 @@ int main(int argc, char* argv[]) {
     AppMode currentMode = AppMode::GAME; // Default mode
     bool setupFlag = false;
     bool bookFlag = false;
+    std::string loadHashFile = ""; // TT snapshot to warm-start from (--load-hash)
+    std::string saveHashFile = ""; // TT snapshot to write on exit (--save-hash)
+    bool useNnueEval = false;            // --eval nnue
+    std::string nnueFile = "jungle.nnue"; // --nnue FILE
+    bool benchFlag = false;               // --bench [depth] [threads] [hash]
+    std::string statsJsonFile = "";       // --stats-json FILE: one line of search statistics per AI move
+    std::string traceFile = "";           // --trace FILE: Chrome trace of search, book, save/load and frames, written on exit
+    int benchArgs[3] = {Bench::DEFAULT_DEPTH, 1, static_cast<int>(Bench::DEFAULT_HASH_MB)};
 
     const char* progName = (argc > 0 && argv[0] != nullptr) ? argv[0] : "jungle_chess";
     if (progName == nullptr) progName = "jungle_chess";
-    std::string usageSyntax = "Usage: " + std::string(progName) + " [--depth N] [--setup | --book] [-n | -d | -h | --help | -?]";
+    std::string usageSyntax = "Usage: " + std::string(progName) + " [--depth N] [--setup | --book] [--load-hash FILE] [--save-hash FILE] [--eval classic|nnue] [--nnue FILE] [--stats-json FILE] [--trace FILE] [--bench [depth] [threads] [hash]] [-n | -d | -h | --help | -?]";
 
 
     for (int i = 1; i < argc; ++i) {
@@ -129,6 +140,40 @@ int main(int argc, char* argv[]) {
             } else {
                 std::cerr << "Error: Missing value after --depth flag." << std::endl; std::cerr << usageSyntax << std::endl; return 1;
             }
+        } else if (strcmp(argv[i], "--eval") == 0) {
+            if (i + 1 < argc && (strcmp(argv[i + 1], "classic") == 0 || strcmp(argv[i + 1], "nnue") == 0)) {
+                useNnueEval = (strcmp(argv[i + 1], "nnue") == 0); i++;
+            } else {
+                std::cerr << "Error: --eval expects 'classic' or 'nnue'." << std::endl; std::cerr << usageSyntax << std::endl; return 1;
+            }
+        } else if (strcmp(argv[i], "--nnue") == 0) {
+            if (i + 1 < argc) { nnueFile = argv[i + 1]; i++; }
+            else { std::cerr << "Error: Missing file name after --nnue flag." << std::endl; std::cerr << usageSyntax << std::endl; return 1; }
+        } else if (strcmp(argv[i], "--load-hash") == 0 || strcmp(argv[i], "--save-hash") == 0) {
+            if (i + 1 < argc) {
+                if (strcmp(argv[i], "--load-hash") == 0) loadHashFile = argv[i + 1];
+                else saveHashFile = argv[i + 1];
+                i++;
+            } else {
+                std::cerr << "Error: Missing file name after " << argv[i] << " flag." << std::endl; std::cerr << usageSyntax << std::endl; return 1;
+            }
+        } else if (strcmp(argv[i], "--stats-json") == 0) {
+            if (i + 1 < argc) { statsJsonFile = argv[i + 1]; i++; }
+            else { std::cerr << "Error: Missing file name after --stats-json flag." << std::endl; std::cerr << usageSyntax << std::endl; return 1; }
+        } else if (strcmp(argv[i], "--trace") == 0) {
+            if (i + 1 < argc) { traceFile = argv[i + 1]; i++; }
+            else { std::cerr << "Error: Missing file name after --trace flag." << std::endl; std::cerr << usageSyntax << std::endl; return 1; }
+        } else if (strcmp(argv[i], "--bench") == 0) {
+            benchFlag = true;
+            // Up to three optional positive numbers: depth, threads, hash MB
+            for (int k = 0; k < 3 && i + 1 < argc && argv[i + 1][0] >= '0' && argv[i + 1][0] <= '9'; ++k) {
+                try {
+                    benchArgs[k] = std::stoi(argv[i + 1]); i++;
+                } catch (const std::exception& e) {
+                    std::cerr << "Error: Invalid number for --bench: '" << argv[i + 1] << "'" << std::endl; return 1;
+                }
+                if (benchArgs[k] <= 0) { std::cerr << "Error: --bench values must be positive." << std::endl; return 1; }
+            }
         } else {
              if (!unknownArgumentFound) { unknownArgumentFound = true; unknownArg = argv[i]; }
         }
@@ -157,6 +202,15 @@ int main(int argc, char* argv[]) {
         std::cout << "  --depth N : Set initial AI search depth to N plies (default: 6).\n";
         std::cout << "  --setup   : Start in board setup mode.\n";
         std::cout << "  --book    : Start in opening book editor mode.\n";
+        std::cout << "  --load-hash FILE : Warm-start the transposition table from a saved snapshot.\n";
+        std::cout << "  --save-hash FILE : Save the transposition table to FILE on exit.\n";
+        std::cout << "  --eval classic|nnue : Evaluation function (default: classic).\n";
+        std::cout << "  --nnue FILE : NNUE weights file for --eval nnue (default: jungle.nnue).\n";
+        std::cout << "  --stats-json FILE : Append one JSON line of search statistics per AI move to FILE.\n";
+        std::cout << "  --trace FILE : Record a timeline (search iterations, root moves, book, save/load, frames) and\n"
+                  << "                 write it to FILE on exit (Chrome Trace Event JSON, open in ui.perfetto.dev).\n";
+        std::cout << "  --bench [depth] [threads] [hash] : Search the built-in position suite, print nodes/NPS/signature and exit\n"
+                  << "                     (default: depth " << Bench::DEFAULT_DEPTH << ", 1 thread, " << Bench::DEFAULT_HASH_MB << " MB hash; no window).\n";
         std::cout << "  -n        : Quiet mode (minimal console output).\n";
         std::cout << "  -d        : Debug mode (verbose AI output).\n";
         std::cout << "  -h, --help, -? : Show this help message and exit.\n\n";
@@ -201,6 +255,51 @@ int main(int argc, char* argv[]) {
     else if (quietMode) { /* no output */ }
 
 
+    // --- Evaluator Selection (before any GameState exists, so accumulators start valid) ---
+    if (useNnueEval) {
+        if (!NNUE::load(nnueFile)) { std::cerr << "Error: Could not load NNUE network, exiting." << std::endl; return 1; }
+        if (!quietMode) std::cout << "NNUE evaluation enabled (" << nnueFile << ")." << std::endl;
+    }
+
+    // --- Timeline Trace ---
+    if (!traceFile.empty()) {
+        if (Trace::start()) Trace::setThreadName("main");
+        else { std::cerr << "Warning: Tracing disabled at compile time, ignoring --trace." << std::endl; traceFile.clear(); }
+    }
+    auto writeTrace = [&]() {
+        if (traceFile.empty()) return;
+        Trace::stop();
+        if (Trace::writeJson(traceFile)) { if (!quietMode) std::cout << "Trace written to " << traceFile << "." << std::endl; }
+    };
+
+    // --- Benchmark (no window) ---
+    if (benchFlag) {
+        Bench::run(benchArgs[0], benchArgs[1], static_cast<size_t>(benchArgs[2]), quietMode);
+        writeTrace();
+        return 0;
+    }
+
+    // --- TT Snapshot (persistent analysis cache) ---
+#ifdef USE_TRANSPOSITION_TABLE
+    if (!saveHashFile.empty()) AI::setPersistentTT(true); // Accumulate over the whole session
+    if (!loadHashFile.empty()) {
+        if (AI::loadTranspositionTable(loadHashFile)) { if (!quietMode) std::cout << "Transposition table loaded from " << loadHashFile << "." << std::endl; }
+        else { std::cerr << "Warning: Starting with an empty transposition table." << std::endl; }
+    }
+#else
+    if (!loadHashFile.empty() || !saveHashFile.empty()) std::cerr << "Warning: Transposition table disabled at compile time, ignoring --load-hash/--save-hash." << std::endl;
+#endif // USE_TRANSPOSITION_TABLE
+
+
+    // --- Search Statistics Log ---
+    std::ofstream statsJsonOut;
+    if (!statsJsonFile.empty()) {
+        statsJsonOut.open(statsJsonFile, std::ios::app);
+        if (!statsJsonOut.is_open()) { std::cerr << "Error opening stats file for writing: " << statsJsonFile << std::endl; return 1; }
+        AI::setTimingStats(true); // Movegen/eval/search time split
+    }
+
+
     // --- Initialization ---
     int currentSearchDepth = initialSearchDepth; // Use separate variable for current depth
     std::string windowTitle = "JungleChess v1.0";
@@ -250,6 +349,7 @@ int main(int argc, char* argv[]) {
 
     // --- Main Loop ---
     while (window.isOpen()) {
+        TRACE_SCOPE("frame", "frame");
         forceAiMove = false; // Reset per frame
         sf::Event event;
         while (window.pollEvent(event)) {
@@ -562,32 +662,36 @@ int main(int argc, char* argv[]) {
 
 
         // --- Drawing ---
-        window.clear(sf::Color(40, 40, 50));
-        graphics.drawBoard(window, gameState, currentMode,
-                           setupPlayer, selectedSetupPiece,
-                           gameOver,
-                           selectedPieceLegalMoves, pieceSelected ? selectedMove.fromRow : -1,
-                           pieceSelected ? selectedMove.fromCol : -1, lastAiMove,
-                           bookStartingSquares, bookTargetSquares,
-                           useBookLookup, currentSearchDepth // Pass game UI state
-                           );
-
-        // Draw Quit/Game Over Overlays
-        if (confirmingQuit) {
-            sf::Font font; if (!font.loadFromFile("assets/arial.ttf")) { std::cerr << "Error loading font!" << std::endl; }
-            else { sf::Text text("Quit game (y/n)?", font, 30); text.setFillColor(sf::Color(240, 240, 240)); text.setStyle(sf::Text::Bold); sf::FloatRect r = text.getLocalBounds(); text.setOrigin(r.left+r.width/2.f, r.top+r.height/2.f); text.setPosition(window.getSize().x/2.f, window.getSize().y/2.f); sf::RectangleShape bg(sf::Vector2f(r.width+60, r.height+40)); bg.setFillColor(sf::Color(50,50,60,235)); bg.setOutlineColor(sf::Color::White); bg.setOutlineThickness(2.f); bg.setOrigin(bg.getSize()/2.f); bg.setPosition(window.getSize().x/2.f, window.getSize().y/2.f); window.draw(bg); window.draw(text); }
-        }
-        else if (currentMode == AppMode::GAME && gameOver) {
-            sf::Font font; if (!font.loadFromFile("assets/arial.ttf")) { std::cerr << "Error loading font!" << std::endl; }
-            else { sf::Text text; text.setFont(font); text.setCharacterSize(40); text.setFillColor(sf::Color(220,220,230)); text.setStyle(sf::Text::Bold); std::string winnerStr = "Winner: " + std::string((winner == Player::PLAYER1) ? "P1(Blue)" : "P2(Red)"); text.setString("Game Over!\n" + winnerStr + "\n" + winReason + "\n\nClick to Exit"); sf::FloatRect r = text.getLocalBounds(); text.setOrigin(r.left+r.width/2.f, r.top+r.height/2.f); text.setPosition(window.getSize().x/2.f, window.getSize().y/2.f); sf::RectangleShape bg(sf::Vector2f(r.width+40, r.height+40)); bg.setFillColor(sf::Color(30,30,40,230)); bg.setOrigin(bg.getSize()/2.f); bg.setPosition(window.getSize().x/2.f, window.getSize().y/2.f); window.draw(bg); window.draw(text); }
+        {
+            TRACE_SCOPE("render", "frame");
+            window.clear(sf::Color(40, 40, 50));
+            graphics.drawBoard(window, gameState, currentMode,
+                               setupPlayer, selectedSetupPiece,
+                               gameOver,
+                               selectedPieceLegalMoves, pieceSelected ? selectedMove.fromRow : -1,
+                               pieceSelected ? selectedMove.fromCol : -1, lastAiMove,
+                               bookStartingSquares, bookTargetSquares,
+                               useBookLookup, currentSearchDepth // Pass game UI state
+                               );
+
+            // Draw Quit/Game Over Overlays
+            if (confirmingQuit) {
+                sf::Font font; if (!font.loadFromFile("assets/arial.ttf")) { std::cerr << "Error loading font!" << std::endl; }
+                else { sf::Text text("Quit game (y/n)?", font, 30); text.setFillColor(sf::Color(240, 240, 240)); text.setStyle(sf::Text::Bold); sf::FloatRect r = text.getLocalBounds(); text.setOrigin(r.left+r.width/2.f, r.top+r.height/2.f); text.setPosition(window.getSize().x/2.f, window.getSize().y/2.f); sf::RectangleShape bg(sf::Vector2f(r.width+60, r.height+40)); bg.setFillColor(sf::Color(50,50,60,235)); bg.setOutlineColor(sf::Color::White); bg.setOutlineThickness(2.f); bg.setOrigin(bg.getSize()/2.f); bg.setPosition(window.getSize().x/2.f, window.getSize().y/2.f); window.draw(bg); window.draw(text); }
+            }
+            else if (currentMode == AppMode::GAME && gameOver) {
+                sf::Font font; if (!font.loadFromFile("assets/arial.ttf")) { std::cerr << "Error loading font!" << std::endl; }
+                else { sf::Text text; text.setFont(font); text.setCharacterSize(40); text.setFillColor(sf::Color(220,220,230)); text.setStyle(sf::Text::Bold); std::string winnerStr = "Winner: " + std::string((winner == Player::PLAYER1) ? "P1(Blue)" : "P2(Red)"); text.setString("Game Over!\n" + winnerStr + "\n" + winReason + "\n\nClick to Exit"); sf::FloatRect r = text.getLocalBounds(); text.setOrigin(r.left+r.width/2.f, r.top+r.height/2.f); text.setPosition(window.getSize().x/2.f, window.getSize().y/2.f); sf::RectangleShape bg(sf::Vector2f(r.width+40, r.height+40)); bg.setFillColor(sf::Color(30,30,40,230)); bg.setOrigin(bg.getSize()/2.f); bg.setPosition(window.getSize().x/2.f, window.getSize().y/2.f); window.draw(bg); window.draw(text); }
+            }
+            window.display();
         }
-        window.display();
 
 
         // --- AI Turn Logic (Only in Game Mode) ---
         if (currentMode == AppMode::GAME && !gameOver && !confirmingQuit &&
            ( (gameState.getCurrentPlayer() == aiPlayer && !waitingForGo) || forceAiMove ) ) {
 
+            TRACE_SCOPE("AI turn", "game");
             if (forceAiMove && gameState.getCurrentPlayer() != aiPlayer) { gameState.setCurrentPlayer(aiPlayer); gameState.recalculateHash(); }
 
             std::vector<Move> aiLegalMovesCheck = gameState.getAllLegalMoves(aiPlayer);
@@ -622,13 +726,26 @@ int main(int argc, char* argv[]) {
                     auto stop = std::chrono::high_resolution_clock::now();
                     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
                     if (aiResult.bestMove.fromRow != -1) {
+                        if (statsJsonOut.is_open()) {
+                            statsJsonOut << "{\"ply\":" << moveHistorySequence.size() << ",\"depth\":" << currentSearchDepth
+                                         << ",\"move\":\"" << Book::moveToAlgebraic(aiResult.bestMove) << "\",\"score\":" << aiResult.finalScore
+                                         << ",\"stats\":" << aiResult.stats.toJson() << "}" << std::endl;
+                        }
                         gameState.applyMove(aiResult.bestMove); lastAiMove = aiResult.bestMove;
                         moveHistorySequence.push_back(aiResult.bestMove); // Add search move
                         if (!quietMode) { // Print stats
                             double durS = duration.count()/1000.0; double nps = (durS > 0.0001) ? (aiResult.nodesSearched/durS) : 0.0;
                             std::cout << "AI time: " << duration.count() << "ms | Nodes: " << aiResult.nodesSearched << " | " << std::fixed << std::setprecision(0) << nps << " N/s";
                             #ifdef USE_TRANSPOSITION_TABLE
-                            std::cout << " | TT Util: " << std::fixed << std::setprecision(1) << aiResult.ttUtilizationPercent << "%";
+                            std::cout << " | TT Util: " << std::fixed << std::setprecision(1) << AI::getTTUtilization() << "%";
+                            #endif
+                            if (NNUE::isActive()) std::cout << " | Eval: NNUE";
+                            #ifdef USE_EVAL_CACHE
+                            uint64_t evalLookups = aiResult.evalCacheHits + aiResult.evalCacheMisses;
+                            if (evalLookups > 0) std::cout << " | Eval Cache Hits: " << std::fixed << std::setprecision(1) << (100.0 * aiResult.evalCacheHits / evalLookups) << "%";
+                            #endif
+                            #ifdef USE_LAZY_EVAL
+                            if (!NNUE::isActive()) std::cout << " | Lazy Eval Exits: " << aiResult.lazyEvalExits;
                             #endif
                             std::cout << std::resetiosflags(std::ios::fixed) << std::endl;
                         }
@@ -639,6 +756,13 @@ int main(int argc, char* argv[]) {
         } // End AI Turn
     } // End game loop
 
+#ifdef USE_TRANSPOSITION_TABLE
+    if (!saveHashFile.empty()) {
+        if (AI::saveTranspositionTable(saveHashFile)) { if (!quietMode) std::cout << "Transposition table saved to " << saveHashFile << "." << std::endl; }
+    }
+#endif // USE_TRANSPOSITION_TABLE
+
+    writeTrace();
     if (!quietMode) std::cout << "Exiting game." << std::endl;
     return 0;
 }
@@ -646,6 +770,7 @@ int main(int argc, char* argv[]) {
 
 // --- Save Game Implementation ---
 bool saveGame(const std::vector<GameState>& history, const std::string& filename) {
+    TRACE_SCOPE("save game", "io");
     std::ofstream outFile(filename, std::ios::binary | std::ios::trunc);
     if (!outFile.is_open()) { std::cerr << "Error opening file for saving: " << filename << std::endl; return false; }
     size_t historySize = history.size();
@@ -668,6 +793,7 @@ bool saveGame(const std::vector<GameState>& history, const std::string& filename
 
 // --- Load Game Implementation ---
 bool loadGame(GameState& currentGameState, const std::string& filename, std::vector<GameState>& history) {
+    TRACE_SCOPE("load game", "io");
     std::ifstream inFile(filename, std::ios::binary);
     if (!inFile.is_open()) { std::cerr << "Error opening file for loading: " << filename << std::endl; return false; }
     size_t historySize = 0; inFile.read(reinterpret_cast<char*>(&historySize), sizeof(historySize));
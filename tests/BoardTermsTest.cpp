@@ -0,0 +1,73 @@
+// Board-term kernels vs. the incremental terms (build target: board_terms_test, run by ctest)
+//
+// Replays seeded random games and checks at every position that the scalar kernel, the AVX2
+// kernel (when this build and CPU have it) and GameState's incrementally maintained
+// material+PST / den threat / den zone terms agree exactly.
+
+#include "GameState.h"
+#include "Evaluation.h"
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+    bool sameTerms(const Evaluation::BoardTerms& a, const Evaluation::BoardTerms& b) {
+        for (int pl = 1; pl <= 2; ++pl) {
+            if (a.materialPst[pl] != b.materialPst[pl] || a.denThreat[pl] != b.denThreat[pl] || a.denZoneCount[pl] != b.denZoneCount[pl]) return false;
+        }
+        return true;
+    }
+
+    void printTerms(const char* label, const Evaluation::BoardTerms& terms) {
+        std::cerr << "  " << label << ":";
+        for (int pl = 1; pl <= 2; ++pl) {
+            std::cerr << " P" << pl << " materialPst " << terms.materialPst[pl] << " denThreat " << terms.denThreat[pl]
+                      << " denZoneCount " << terms.denZoneCount[pl];
+        }
+        std::cerr << std::endl;
+    }
+
+} // namespace
+
+int main() {
+    const int games = 1500, maxPlies = 200;
+    std::mt19937_64 rng(20240611);
+    Evaluation::BoardPlanes planes;
+    bool haveAVX2 = false;
+    uint64_t positions = 0;
+    for (int game = 0; game < games; ++game) {
+        GameState state;
+        for (int ply = 0; ply <= maxPlies; ++ply) {
+            Evaluation::fillBoardPlanes(state.getBoard(), planes);
+            Evaluation::BoardTerms scalar = Evaluation::computeBoardTermsScalar(planes);
+            Evaluation::BoardTerms incremental;
+            for (Player player : {Player::PLAYER1, Player::PLAYER2}) {
+                int pl = static_cast<int>(player);
+                incremental.materialPst[pl] = state.getMaterialPst(player);
+                incremental.denThreat[pl] = state.getDenThreat(player);
+                incremental.denZoneCount[pl] = state.getDenZoneCount(player);
+            }
+            Evaluation::BoardTerms avx2 = scalar;
+            bool avx2Ran = Evaluation::computeBoardTermsAVX2(planes, avx2);
+            haveAVX2 = haveAVX2 || avx2Ran;
+            if (!sameTerms(scalar, incremental) || (avx2Ran && !sameTerms(scalar, avx2))) {
+                std::cerr << "FAIL: board terms differ in game " << game << " ply " << ply << ": " << state.toNotation() << std::endl;
+                printTerms("scalar", scalar);
+                printTerms("incremental", incremental);
+                if (avx2Ran) printTerms("AVX2", avx2);
+                return 1;
+            }
+            ++positions;
+
+            if (state.checkWinner() != Player::NONE) break;
+            std::vector<Move> moves = state.getAllLegalMoves(state.getCurrentPlayer());
+            if (moves.empty()) break;
+            state.applyMove(moves[rng() % moves.size()]);
+            state.switchPlayer();
+        }
+    }
+    std::cout << positions << " positions, scalar == incremental" << (haveAVX2 ? " == AVX2" : " (no AVX2 kernel on this build/CPU)") << std::endl;
+    std::cout << "PASS" << std::endl;
+    return 0;
+}
@@ -0,0 +1,30 @@
+// Eval cache vs. the 'weakened' flag (build target: eval_cache_test, run by ctest)
+//
+// The two positions below differ only in a weakened Tiger, so they share a Zobrist key, but the
+// mobility/capture-threat terms see the weakened piece and evaluate them differently. An engine
+// that has just searched the first position must give the second the same score as a fresh
+// engine: a cache keyed on the Zobrist key alone would hand back the first position's evals.
+
+#include "AI.h"
+#include "Evaluation.h"
+#include <iostream>
+
+int main() {
+    const char* plain = "5l1/1cw1d2/t1e4/1R1p2r/7/7/2P1E1T/3D1C1/L3W2 1";
+    const char* weakened = "5l1/1cw1d2/t*1e4/1R1p2r/7/7/2P1E1T/3D1C1/L3W2 1";
+    GameState a, b;
+    if (!a.fromNotation(plain) || !b.fromNotation(weakened)) { std::cerr << "FAIL: test positions don't parse" << std::endl; return 1; }
+    if (a.getHashKey() != b.getHashKey()) { std::cerr << "FAIL: expected equal Zobrist keys (weakened flag isn't hashed)" << std::endl; return 1; }
+    if (a.getHashKeyWithWeakened() == b.getHashKeyWithWeakened()) { std::cerr << "FAIL: getHashKeyWithWeakened() ignores the weakened Tiger" << std::endl; return 1; }
+
+    const int depth = 1; // Every child is a cached leaf evaluation
+    Engine shared(1), fresh(1);
+    int plainScore = shared.getBestMove(a, depth, false, true).finalScore;
+    int sharedScore = shared.getBestMove(b, depth, false, true).finalScore;
+    int freshScore = fresh.getBestMove(b, depth, false, true).finalScore;
+    std::cout << "plain " << plainScore << ", weakened " << freshScore << " (fresh engine), " << sharedScore << " (after plain)" << std::endl;
+    if (plainScore == freshScore) { std::cerr << "FAIL: the weakened Tiger no longer changes the score, pick another position" << std::endl; return 1; }
+    if (sharedScore != freshScore) { std::cerr << "FAIL: eval cache returned the unweakened position's evaluations" << std::endl; return 1; }
+    std::cout << "PASS" << std::endl;
+    return 0;
+}